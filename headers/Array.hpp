@@ -1,6 +1,9 @@
 #pragma once
 
 #include "./numc_types.hpp"
+#include "./half.hpp"
+#include "./Shape.hpp"
+#include "./storage.hpp"
 #include "./Mask.hpp"
 #include "./Viewer.hpp"
 #include "./global_methods.hpp"
@@ -12,6 +15,13 @@
 namespace SamH::NumC
 {
 
+namespace Global::detail
+{
+    // Formatting behind Array::print_data, defined with the text I/O
+    template <typename Values>
+    void print_values(const Values& values, const Shape& dims);
+}
+
 template <typename T>
 class Array 
 {
@@ -28,6 +38,8 @@ public:
     arg_type operator[](arg_type idx) const;
 
     arg_type size() const;
+    arg_type start() const;
+    arg_type step() const;
 
 private:
     arg_type valid_step(arg_type step) const;
@@ -39,8 +51,9 @@ private:
 };
 
 public:
-    using iterator = typename std::vector<T>::iterator;
-    using const_iterator = typename std::vector<T>::const_iterator;
+    using storage_type = std::vector<T, AlignedAllocator<T>>;
+    using iterator = typename storage_type::iterator;
+    using const_iterator = typename storage_type::const_iterator;
 
     // Begin / End for non-const Array
     iterator begin() { return n_data.begin(); }
@@ -57,24 +70,39 @@ public:
     Array(arg_type size = 0, const T& elem = T());
     Array(const T* arr, const arg_type len);
     Array(const std::vector<T>& vector);
-    Array(const std::vector<arg_type>& shape, T fill);
+    Array(const Shape& shape, T fill);
     Array(const T* from, const T* to);
     Array(const Array& rhv);
+    Array(Array&& rhv) noexcept;
     Array(const std::initializer_list<T>& init);
     inline Array(const Viewer<T>& view);
+
+    // Allocated but, for trivially constructible T, left uninitialized
+    static Array<T> uninitialized(const Shape& shape);
     
     Array& operator=(const Array& rhv);
+    Array& operator=(Array&& rhv) noexcept;
     
     void push_back(const T& rhv);
     void pop_back();
     
-    const T& get_value(const std::vector<arg_type>& args) const;
-    T& get_value(const std::vector<arg_type>& args);
+    const T& get_value(const Shape& args) const;
+    T& get_value(const Shape& args);
     Viewer<T> operator()(const std::vector<Slice>& slices);
     Array<T>  operator()(const std::vector<Slice>& slices) const;
 
+    // Axis permutations: a zero-copy view, or a materialized copy when const
+    Viewer<T> transpose();
+    Viewer<T> transpose(const Shape& axes);
+    Viewer<T> swapaxes(arg_type first, arg_type second);
+    Viewer<T> moveaxis(arg_type source, arg_type destination);
+    Array<T>  transpose() const;
+    Array<T>  transpose(const Shape& axes) const;
+    Array<T>  swapaxes(arg_type first, arg_type second) const;
+    Array<T>  moveaxis(arg_type source, arg_type destination) const;
+
     Array<T> clip(arg_type min_val, arg_type max_val) const;
-    Array<T> reshape(const std::vector<arg_type>& new_shape);
+    Array<T> reshape(const Shape& new_shape);
     
     Array<T> unique() const;
     Array<T> unique_sorted() const;
@@ -121,6 +149,12 @@ public:
     Array<T> operator-(const Array<T>& rhv) const;
     Array<T> operator*(const Array<T>& rhv) const;
     Array<T> operator/(const Array<T>& rhv) const;
+
+    // Mixed element types: broadcast and convert to promote_t<T, U> inside the kernel
+    template <typename U> Array<promote_t<T, U>> operator+(const Array<U>& rhv) const;
+    template <typename U> Array<promote_t<T, U>> operator-(const Array<U>& rhv) const;
+    template <typename U> Array<promote_t<T, U>> operator*(const Array<U>& rhv) const;
+    template <typename U> Array<promote_t<T, U>> operator/(const Array<U>& rhv) const;
     
     Mask operator> (const Array<T>& rhv) const;
     Mask operator< (const Array<T>& rhv) const;
@@ -148,7 +182,7 @@ public:
 
     // Bool type - non-const (vector<bool> proxy reference)
     template <typename U = T>
-    typename std::enable_if<std::is_same<U, bool>::value, typename std::vector<bool>::reference>::type
+    typename std::enable_if<std::is_same<U, bool>::value, typename storage_type::reference>::type
     operator[](arg_type index);
 
     // Bool type - const (returns by value)
@@ -159,8 +193,27 @@ public:
     Array<T> operator[](const Mask& rhv) const;
     Array<T> operator[](const std::vector<bool>& rhv) const;
 
+    // Integer-array indexing into the flattened array, the result has the shape of
+    // indices. Negative indices count from the end.
+    Array<T> operator[](const Array<arg_type>& indices) const;
+    Array<T> take(const Array<arg_type>& indices) const;
+    // Whole slices along axis: shape[:axis] + indices.shape + shape[axis + 1:]
+    Array<T> take(const Array<arg_type>& indices, arg_type axis) const;
+
+    // self[indices[j]] = values[j], the last of repeated indices wins. values holds one
+    // value (or slice along axis) per index, or a single value for all of them.
+    void put(const Array<arg_type>& indices, const Array<T>& values);
+    void put(const Array<arg_type>& indices, const Array<T>& values, arg_type axis);
+
+    // self[indices[j]] += values[j], repeated indices accumulate
+    void scatter_add(const Array<arg_type>& indices, const Array<T>& values);
+    void scatter_add(const Array<arg_type>& indices, const Array<T>& values, arg_type axis);
+
     arg_type size() const;
-    const std::vector<arg_type>& shape() const;
+    T* data();
+    const T* data() const;
+    const Shape& shape() const;
+    const Shape& strides() const;
     template <typename U> Array<U> cast() const;
     void print_data() const;
     void print_dims() const;
@@ -187,13 +240,24 @@ private:
     template <typename U, typename List>
     friend Array<U> make_array_impl(const List& init);
 
+    inline Viewer<T> full_view() const;
+
     inline static Broadcast can_broadcast(const Array<T>& first, const Array<T>& second);
-    inline static Array<T> broadcast(const Array<T>& arr, const std::vector<arg_type>& dims);
+    inline static Array<T> broadcast(const Array<T>& arr, const Shape& dims);
     inline static Array<T> calculate(const Array<T>& first, const Array<T>& second, Sign sign);
 
+    template <typename U>
+    Array<promote_t<T, U>> calculate_mixed(const Array<U>& rhv, Sign sign) const;
+
+    // Recomputes the cached row-major strides, must follow every change of n_dims
+    void update_strides();
+    // Leaves a moved-from array empty and one-dimensional
+    void reset_empty() noexcept;
+
 private:
-    std::vector<T> n_data;
-    std::vector<arg_type> n_dims;
+    storage_type n_data;
+    Shape n_dims;
+    Shape n_strides;
 };
 
 inline Mask logical_and(const Mask& x, const Mask& y);
@@ -206,4 +270,6 @@ inline Mask logical_not(const Mask& arr);
 #include "../templates/Array.ipp"
 #include "./make_array.hpp"
 #include "./Slice_impl.hpp"
-#include "./random.hpp"
\ No newline at end of file
+#include "./random.hpp"
+#include "./indexing.hpp"
+#include "./text_io.hpp"
@@ -0,0 +1,20 @@
+#pragma once
+
+// Every NumC module. Array.hpp alone gives the array type with its indexing,
+// printing and random generators; each module header below includes what it
+// builds on, so any of them can also be included on its own.
+#include "./Array.hpp"
+#include "./StaticArray.hpp"
+#include "./SparseArray.hpp"
+#include "./statistics.hpp"
+#include "./cumulative.hpp"
+#include "./fft.hpp"
+#include "./convolve.hpp"
+#include "./plan.hpp"
+#include "./columnar.hpp"
+#include "./linalg.hpp"
+#include "./sampling.hpp"
+#include "./shared.hpp"
+#include "./rolling.hpp"
+#include "./groupby.hpp"
+#include "./setops.hpp"
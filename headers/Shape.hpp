@@ -0,0 +1,141 @@
+#pragma once
+
+#include "./numc_types.hpp"
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+#include <algorithm>
+#include <cassert>
+
+namespace SamH::NumC
+{
+
+// Dimension list (extents, strides or coordinates).
+// Up to INLINE_DIMS entries are stored inline, so typical shapes never touch the heap.
+class Shape
+{
+public:
+    static constexpr std::size_t INLINE_DIMS = 8;
+
+    using value_type = arg_type;
+    using iterator = arg_type*;
+    using const_iterator = const arg_type*;
+
+    iterator begin() { return data(); }
+    iterator end()   { return data() + s_size; }
+
+    const_iterator begin() const { return data(); }
+    const_iterator end()   const { return data() + s_size; }
+
+    const_iterator cbegin() const { return data(); }
+    const_iterator cend()   const { return data() + s_size; }
+
+public:
+    Shape() : s_size(0) {}
+    explicit Shape(std::size_t count, arg_type value = 0) : s_size(0) { resize(count, value); }
+    Shape(const std::initializer_list<arg_type>& init) : s_size(0) { assign(init.begin(), init.end()); }
+    Shape(const std::vector<arg_type>& vec) : s_size(0) { assign(vec.begin(), vec.end()); }
+
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    Shape(It first, It last) : s_size(0) { assign(first, last); }
+
+    Shape(const Shape& rhv) : s_size(0) { assign(rhv.begin(), rhv.end()); }
+
+    Shape& operator=(const Shape& rhv)
+    {
+        if (this != &rhv) assign(rhv.begin(), rhv.end());
+        return *this;
+    }
+
+    operator std::vector<arg_type>() const { return std::vector<arg_type>(begin(), end()); }
+
+    template <typename It>
+    void assign(It first, It last)
+    {
+        const std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+        if (count > INLINE_DIMS) {
+            s_heap.assign(first, last);
+        } else {
+            s_heap.clear();
+            std::copy(first, last, s_inline);
+        }
+        s_size = count;
+    }
+
+    void resize(std::size_t count, arg_type value = 0)
+    {
+        if (count > INLINE_DIMS) {
+            if (s_size <= INLINE_DIMS) s_heap.assign(s_inline, s_inline + s_size);
+            s_heap.resize(count, value);
+        } else {
+            if (s_size > INLINE_DIMS) std::copy(s_heap.begin(), s_heap.begin() + count, s_inline);
+            else if (count > s_size) std::fill(s_inline + s_size, s_inline + count, value);
+            s_heap.clear();
+        }
+        s_size = count;
+    }
+
+    void push_back(arg_type value)
+    {
+        if (s_size < INLINE_DIMS) {
+            s_inline[s_size++] = value;
+        } else {
+            if (s_size == INLINE_DIMS) s_heap.assign(s_inline, s_inline + INLINE_DIMS);
+            s_heap.push_back(value);
+            ++s_size;
+        }
+    }
+
+    void pop_back() { assert(s_size > 0); resize(s_size - 1); }
+
+    iterator insert(const_iterator pos, arg_type value)
+    {
+        const std::size_t at = static_cast<std::size_t>(pos - begin());
+        push_back(value);
+        std::rotate(begin() + at, end() - 1, end());
+        return begin() + at;
+    }
+
+    void clear() { s_heap.clear(); s_size = 0; }
+
+    arg_type* data() { return s_size > INLINE_DIMS ? s_heap.data() : s_inline; }
+    const arg_type* data() const { return s_size > INLINE_DIMS ? s_heap.data() : s_inline; }
+
+    arg_type& operator[](std::size_t index) { return data()[index]; }
+    const arg_type& operator[](std::size_t index) const { return data()[index]; }
+
+    arg_type& front() { return data()[0]; }
+    arg_type& back()  { return data()[s_size - 1]; }
+    const arg_type& front() const { return data()[0]; }
+    const arg_type& back()  const { return data()[s_size - 1]; }
+
+    std::size_t size() const { return s_size; }
+    bool empty() const { return s_size == 0; }
+
+    // Product of all entries (element count for an extent list)
+    arg_type total() const
+    {
+        arg_type res = 1;
+        for (auto d : *this) res *= d;
+        return res;
+    }
+
+    // Row-major strides for this extent list
+    Shape strides() const
+    {
+        Shape res(s_size, 1);
+        for (arg_type i = static_cast<arg_type>(s_size) - 2; i >= 0; --i)
+            res[i] = res[i + 1] * (*this)[i + 1];
+        return res;
+    }
+
+    bool operator==(const Shape& rhv) const { return std::equal(begin(), end(), rhv.begin(), rhv.end()); }
+    bool operator!=(const Shape& rhv) const { return !(*this == rhv); }
+
+private:
+    arg_type s_inline[INLINE_DIMS];
+    std::vector<arg_type> s_heap;
+    std::size_t s_size;
+};
+
+}
@@ -48,6 +48,20 @@ Array<T>::Slice::size() const
     }
 }
 
+template <typename T>
+arg_type 
+Array<T>::Slice::start() const
+{
+    return s_begin;
+}
+
+template <typename T>
+arg_type 
+Array<T>::Slice::step() const
+{
+    return s_step;
+}
+
 template <typename T>
 arg_type 
 Array<T>::Slice::valid_step(arg_type step) const
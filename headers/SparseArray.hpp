@@ -0,0 +1,95 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include <vector>
+
+namespace SamH::NumC
+{
+
+// 2-D sparse matrix stored as compressed rows (CSR), compressed columns (CSC)
+// or coordinate triplets (COO). Compressed formats keep indices sorted and unique.
+template <typename T>
+class SparseArray
+{
+public:
+    enum Format
+    {
+        CSR,
+        CSC,
+        COO
+    };
+
+public:
+    SparseArray(arg_type rows = 0, arg_type cols = 0, Format format = CSR);
+    explicit SparseArray(const Array<T>& dense, Format format = CSR);
+    SparseArray(const Array<T>& dense, const Mask& selection, Format format = CSR);
+
+    // Builds from (row, col, value) triplets; duplicate coordinates are summed
+    static SparseArray from_triplets(arg_type rows, arg_type cols,
+                                     const Array<arg_type>& row_idx,
+                                     const Array<arg_type>& col_idx,
+                                     const Array<T>& values,
+                                     Format format = CSR);
+
+    Format format() const;
+    SparseArray asformat(Format format) const;
+    Array<T> to_dense() const;
+
+    arg_type rows() const;
+    arg_type cols() const;
+    arg_type nnz() const;
+    Shape shape() const;
+    double density() const;
+
+    T get_value(arg_type row, arg_type col) const;
+
+    // SpMV for a 1-D operand, SpMM for a 2-D one
+    Array<T> dot(const Array<T>& rhv) const;
+
+    // Elementwise operations, the result keeps the union (+, -) or intersection (*) pattern
+    SparseArray operator+(const SparseArray& rhv) const;
+    SparseArray operator-(const SparseArray& rhv) const;
+    SparseArray operator*(const SparseArray& rhv) const;
+    SparseArray operator*(const Array<T>& rhv) const;
+    SparseArray operator*(const T& rhv) const;
+    SparseArray operator/(const T& rhv) const;
+
+    SparseArray transpose() const;
+
+    T sum() const;
+    Array<T> sum(arg_type axis) const;
+    Array<T> mean(arg_type axis) const;
+    Array<T> min(arg_type axis) const;
+    Array<T> max(arg_type axis) const;
+
+    void print_data() const;
+
+private:
+    // Compressed copy in the requested orientation (CSR or CSC)
+    SparseArray compressed(Format format) const;
+    static SparseArray from_coo(arg_type rows, arg_type cols,
+                                std::vector<arg_type> row_idx,
+                                std::vector<arg_type> col_idx,
+                                std::vector<T> values,
+                                Format format);
+
+    template <typename Op>
+    SparseArray merge(const SparseArray& rhv, Op op, bool keep_union) const;
+
+    template <typename Op>
+    Array<T> reduce(arg_type axis, Op op, T init, bool with_zeros) const;
+
+private:
+    Format s_format;
+    arg_type s_rows;
+    arg_type s_cols;
+    std::vector<arg_type> s_indptr;    // CSR row / CSC column pointers
+    std::vector<arg_type> s_indices;   // CSR column / CSC row / COO column indices
+    std::vector<arg_type> s_coo_rows;  // COO row indices
+    std::vector<T> s_values;
+};
+
+}
+
+#include "../templates/SparseArray.ipp"
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "./Array.hpp"
+#include <array>
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+
+namespace SamH::NumC
+{
+
+namespace detail
+{
+    // Calls f(0), f(1), ..., f(N - 1) as a fold expression so the loop is fully unrolled
+    template <typename F, std::size_t... I>
+    constexpr void static_unroll(F&& f, std::index_sequence<I...>) { (f(I), ...); }
+
+    // Largest element count that is unrolled, bigger arrays fall back to a plain loop
+    constexpr arg_type STATIC_UNROLL_LIMIT = 64;
+}
+
+// Fixed-shape array with inline storage; shape and strides are compile-time constants
+template <typename T, arg_type... Dims>
+class StaticArray
+{
+    static_assert(sizeof...(Dims) > 0, "StaticArray requires at least one dimension");
+    static_assert(((Dims > 0) && ...), "StaticArray dimensions must be positive");
+
+public:
+    static constexpr arg_type ndim  = sizeof...(Dims);
+    static constexpr arg_type total = (Dims * ...);
+    static constexpr std::array<arg_type, ndim> dims = { Dims... };
+    static constexpr bool is_square = (ndim == 2 && dims[0] == dims[ndim - 1]);
+
+private:
+    static constexpr std::array<arg_type, ndim> compute_strides()
+    {
+        std::array<arg_type, ndim> res{};
+        res[ndim - 1] = 1;
+        for (arg_type i = ndim - 2; i >= 0; --i) res[i] = res[i + 1] * dims[i + 1];
+        return res;
+    }
+
+public:
+    static constexpr std::array<arg_type, ndim> strides = compute_strides();
+
+    using iterator = typename std::array<T, total>::iterator;
+    using const_iterator = typename std::array<T, total>::const_iterator;
+
+    iterator begin() { return n_data.begin(); }
+    iterator end()   { return n_data.end(); }
+
+    const_iterator begin() const { return n_data.begin(); }
+    const_iterator end()   const { return n_data.end(); }
+
+public:
+    constexpr StaticArray() : n_data{} {}
+    explicit StaticArray(const T& fill);
+    StaticArray(const std::initializer_list<T>& init);
+    explicit StaticArray(const Array<T>& arr);
+
+    operator Array<T>() const;
+    Array<T> to_array() const;
+
+    template <typename... Idx>
+    T& operator()(Idx... idx);
+
+    template <typename... Idx>
+    const T& operator()(Idx... idx) const;
+
+    T& operator[](arg_type index);
+    const T& operator[](arg_type index) const;
+
+    StaticArray operator+(const StaticArray& rhv) const;
+    StaticArray operator-(const StaticArray& rhv) const;
+    StaticArray operator*(const StaticArray& rhv) const;
+    StaticArray operator/(const StaticArray& rhv) const;
+
+    StaticArray operator+(const T& rhv) const;
+    StaticArray operator-(const T& rhv) const;
+    StaticArray operator*(const T& rhv) const;
+    StaticArray operator/(const T& rhv) const;
+
+    StaticArray& operator+=(const StaticArray& rhv);
+    StaticArray& operator-=(const StaticArray& rhv);
+    StaticArray& operator*=(const StaticArray& rhv);
+    StaticArray& operator/=(const StaticArray& rhv);
+
+    bool operator==(const StaticArray& rhv) const;
+    bool operator!=(const StaticArray& rhv) const;
+
+    // Inner product for 1-D operands, matrix product for 2-D ones
+    template <arg_type... RDims>
+    auto dot(const StaticArray<T, RDims...>& rhv) const;
+
+    T sum() const;
+    T min() const;
+    T max() const;
+
+    // Square 2-D only
+    T det() const;
+    StaticArray inverse() const;
+    StaticArray transpose() const;
+
+    static constexpr arg_type size() { return total; }
+    static constexpr const std::array<arg_type, ndim>& shape() { return dims; }
+
+    T* data() { return n_data.data(); }
+    const T* data() const { return n_data.data(); }
+
+    void print_data() const;
+
+private:
+    template <typename U, arg_type... D>
+    friend class StaticArray;
+
+    template <typename F>
+    static void for_each_index(F&& f);
+
+    template <typename Op>
+    StaticArray apply(const StaticArray& rhv, Op op) const;
+
+private:
+    std::array<T, total> n_data;
+};
+
+}
+
+#include "../templates/StaticArray.ipp"
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "./numc_types.hpp"
+#include "./Shape.hpp"
+#include "./parallel.hpp"
 #include <vector>
 
 namespace SamH::NumC
@@ -16,16 +18,40 @@ struct Viewer
 
     T* data_begin;
     T* data_end;
-    std::vector<arg_type> dims;
+    Shape dims;
     std::vector<Slice> views; 
 
+    // Cached on construction: extent of every view dimension, the element stride
+    // of one step along it (slice step folded in) and the offset of the first element
+    Shape shape;
+    Shape strides;
+    arg_type offset;
+
     Viewer(T* dt_b = nullptr
          , T* dt_e = nullptr
-         , const std::vector<arg_type>& shape = {}
+         , const Shape& parent_shape = {}
          , const std::vector<Slice>& slices = {});
     
-    T operator()(const std::vector<arg_type>& coords) const;
-    T& operator()(const std::vector<arg_type>& coords);
+    T operator()(const Shape& coords) const;
+    T& operator()(const Shape& coords);
+
+    arg_type size() const;
+
+    // Calls func(i, data_offset) for every element of the view in row-major order
+    template <typename F>
+    void for_each_offset(F func) const;
+
+    // Zero-copy axis permutations sharing the parent data
+    Viewer<T> transpose() const;
+    Viewer<T> transpose(const Shape& axes) const;
+    Viewer<T> swapaxes(arg_type first, arg_type second) const;
+    Viewer<T> moveaxis(arg_type source, arg_type destination) const;
+
+    bool is_contiguous() const;
+
+    // Row-major copy of the view into dst; permuted views are copied tile by tile
+    void copy_to(T* dst) const;
+    Array<T> ascontiguous() const;
 
     void operator=(const std::vector<T>& data);
     void operator=(const T& scalar_value);
@@ -41,6 +67,45 @@ struct Viewer
     }
 
 };
+
+// Read-only view over data that must not be written, such as a read-only mapping.
+// Wraps a Viewer and exposes only its const operations.
+template <typename T>
+class ConstViewer
+{
+public:
+    using Slice = typename Viewer<T>::Slice;
+
+    ConstViewer(const T* dt_b = nullptr
+              , const T* dt_e = nullptr
+              , const Shape& parent_shape = {}
+              , const std::vector<Slice>& slices = {});
+
+    T operator()(const Shape& coords) const;
+
+    arg_type size() const;
+    const Shape& shape() const;
+    bool is_contiguous() const;
+
+    ConstViewer<T> transpose() const;
+    ConstViewer<T> transpose(const Shape& axes) const;
+    ConstViewer<T> swapaxes(arg_type first, arg_type second) const;
+    ConstViewer<T> moveaxis(arg_type source, arg_type destination) const;
+
+    void copy_to(T* dst) const;
+    Array<T> ascontiguous() const;
+
+    operator Array<T>() const
+    {
+        return Array<T>(c_view);
+    }
+
+private:
+    explicit ConstViewer(const Viewer<T>& view);
+
+private:
+    Viewer<T> c_view;
+};
 }
 
 #include "../templates/Viewer.ipp"
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./Mask.hpp"
+#include "./parallel.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace SamH::NumC::Columnar
+{
+    // Layout: "NUMCCOL1", the encoded chunks, a footer with the element type, shape and one
+    // zone map per chunk, then the footer offset and the magic again. Values are stored
+    // in native byte order.
+    constexpr arg_type DEFAULT_CHUNK = arg_type(1) << 16;
+
+    enum Encoding
+    {
+        PLAIN,          // raw values
+        CONSTANT,       // every value equals the chunk minimum, no payload
+        FRAME,          // value - min, bit-packed
+        DELTA,          // first value and differences from the previous one, bit-packed
+        RLE             // run lengths of alternating booleans
+    };
+
+    enum Compare
+    {
+        GREATER,
+        GREATER_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        EQUAL,
+        NOT_EQUAL
+    };
+
+    // Exact accumulator for chunk sums
+    template <typename T>
+    using sum_type = std::conditional_t<std::is_floating_point_v<T>, double,
+                     std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+    // Zone map of one chunk; NaNs are counted in `count` but not in `valid`, min, max or sum
+    template <typename T>
+    struct ChunkInfo
+    {
+        std::int64_t offset;
+        std::int64_t bytes;
+        std::int64_t count;
+        std::int64_t valid;
+        Encoding encoding;
+        T min;
+        T max;
+        sum_type<T> sum;
+    };
+
+    // Writes arr in chunks of chunk_size elements. With compress every chunk takes the
+    // smallest of the encodings that apply to its values, otherwise PLAIN.
+    template <typename T>
+    void write(const std::string& path, const Array<T>& arr, arg_type chunk_size = DEFAULT_CHUNK, bool compress = true);
+
+    // Masks are stored run-length encoded, the zone map sum is the number of set values
+    inline void write(const std::string& path, const Mask& mask, arg_type chunk_size = DEFAULT_CHUNK);
+    inline Mask read_mask(const std::string& path);
+    inline arg_type count_mask(const std::string& path);
+
+    // Reads only the footer on construction. Queries consult the zone maps first and
+    // decode a chunk only when its statistics can't decide the answer.
+    template <typename T>
+    class Reader
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                      "Columnar::Reader requires a numeric element type, use read_mask for masks");
+
+    public:
+        explicit Reader(const std::string& path);
+
+        const Shape& shape() const;
+        arg_type size() const;
+        arg_type chunk_size() const;
+        arg_type chunk_count() const;
+        const ChunkInfo<T>& chunk(arg_type index) const;
+
+        Array<T> read();
+        Array<T> read_chunk(arg_type index);
+
+        // Answered from the zone maps without decoding
+        sum_type<T> sum() const;
+        T min() const;
+        T max() const;
+
+        // Elementwise `value[i] op rhv` over the whole array
+        arg_type count(Compare op, T rhv);
+        Mask compare(Compare op, T rhv);
+        // Matching values in storage order, 1-D
+        Array<T> select(Compare op, T rhv);
+
+        // Chunks decoded since construction, to check how much a query touched
+        arg_type chunks_decoded() const;
+
+    private:
+        enum Verdict
+        {
+            NO_MATCH,
+            ALL_MATCH,
+            PARTIAL
+        };
+
+        Verdict classify(const ChunkInfo<T>& info, Compare op, T rhv) const;
+        void decode(arg_type index, T* out);
+
+    private:
+        std::ifstream r_file;
+        Shape r_shape;
+        arg_type r_chunk_size;
+        std::vector<ChunkInfo<T>> r_chunks;
+        std::vector<char> r_payload;
+        arg_type r_decoded = 0;
+    };
+}
+
+#include "../templates/columnar.ipp"
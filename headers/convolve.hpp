@@ -0,0 +1,45 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include "./fft.hpp"
+
+namespace SamH::NumC::Global
+{
+    // Output extent: the full overlap, centered on the longer input, or only
+    // the positions where the inputs overlap completely
+    enum ConvolveMode
+    {
+        FULL,
+        SAME,
+        VALID
+    };
+
+    // AUTO compares the estimated cost of both paths for the given sizes
+    enum ConvolveMethod
+    {
+        AUTO,
+        DIRECT,
+        SPECTRAL
+    };
+
+    // 1-D discrete convolution and cross-correlation
+    template <typename T>
+    Array<T> convolve(const Array<T>& signal, const Array<T>& kernel,
+                      ConvolveMode mode = FULL, ConvolveMethod method = AUTO);
+
+    template <typename T>
+    Array<T> correlate(const Array<T>& signal, const Array<T>& kernel,
+                       ConvolveMode mode = VALID, ConvolveMethod method = AUTO);
+
+    // 2-D discrete convolution and cross-correlation
+    template <typename T>
+    Array<T> convolve2d(const Array<T>& image, const Array<T>& kernel,
+                        ConvolveMode mode = FULL, ConvolveMethod method = AUTO);
+
+    template <typename T>
+    Array<T> correlate2d(const Array<T>& image, const Array<T>& kernel,
+                         ConvolveMode mode = FULL, ConvolveMethod method = AUTO);
+}
+
+#include "../templates/convolve.ipp"
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+
+namespace SamH::NumC::Global
+{
+    // Cumulative operations. Without an axis the array is scanned flattened and the
+    // result is 1-D; the `out` overloads write into a preallocated array of the result
+    // shape (it may be the input itself).
+    #define DECLARE_CUMULATIVE_FUNC(NAME) \
+    template <typename T> Array<T> NAME(const Array<T>& arr); \
+    template <typename T> Array<T> NAME(const Array<T>& arr, arg_type axis); \
+    template <typename T> void NAME(const Array<T>& arr, Array<T>& out); \
+    template <typename T> void NAME(const Array<T>& arr, arg_type axis, Array<T>& out);
+
+    DECLARE_CUMULATIVE_FUNC(cumsum)
+    DECLARE_CUMULATIVE_FUNC(cumprod)
+    DECLARE_CUMULATIVE_FUNC(cummin)
+    DECLARE_CUMULATIVE_FUNC(cummax)
+
+    #undef DECLARE_CUMULATIVE_FUNC
+
+    // n-th discrete difference along axis, the axis shrinks by n
+    template <typename T>
+    Array<T> diff(const Array<T>& arr, arg_type n = 1, arg_type axis = -1);
+}
+
+#include "../templates/cumulative.ipp"
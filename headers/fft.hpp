@@ -0,0 +1,93 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace SamH::NumC::FFT
+{
+    using complex = std::complex<double>;
+
+    // Precomputed transform for one length: mixed-radix Cooley-Tukey (radix 4, 2, 3, 5
+    // and generic small primes) or Bluestein's chirp-z algorithm when the length has a
+    // large prime factor. Plans are immutable and shared through a per-size cache.
+    class Plan
+    {
+    public:
+        explicit Plan(arg_type n);
+
+        // Cached plan for length n, twiddle factors are computed once per size
+        static std::shared_ptr<const Plan> get(arg_type n);
+
+        arg_type size() const;
+
+        // Unnormalized transform of n values; in and out may be the same buffer
+        void execute(const complex* in, complex* out, bool inverse) const;
+
+    private:
+        void work(complex* out, const complex* in, arg_type fstride, arg_type in_stride,
+                  const arg_type* factors, bool inverse) const;
+
+        void butterfly2(complex* out, arg_type fstride, arg_type m, bool inverse) const;
+        void butterfly3(complex* out, arg_type fstride, arg_type m, bool inverse) const;
+        void butterfly4(complex* out, arg_type fstride, arg_type m, bool inverse) const;
+        void butterfly_generic(complex* out, arg_type fstride, arg_type m, arg_type p, bool inverse) const;
+
+        void bluestein(const complex* in, complex* out) const;
+
+    private:
+        arg_type p_n;
+        std::vector<arg_type> p_factors;      // (radix, remaining length) pairs
+        std::vector<complex> p_twiddles;      // e^{-2 pi i k / n}
+        std::vector<complex> p_itwiddles;     // e^{+2 pi i k / n}
+
+        bool p_bluestein;
+        std::vector<complex> p_chirp;         // e^{-i pi k^2 / n}
+        std::vector<complex> p_chirp_fft;     // FFT of the zero-padded conjugate chirp
+        std::shared_ptr<const Plan> p_inner;  // power-of-two plan for the convolution
+    };
+
+    // Plan for real input of even length n, packed as an n / 2 complex transform
+    class RealPlan
+    {
+    public:
+        explicit RealPlan(arg_type n);
+
+        static std::shared_ptr<const RealPlan> get(arg_type n);
+
+        arg_type size() const;
+
+        // n real values -> n / 2 + 1 complex values
+        void forward(const double* in, complex* out) const;
+        // n / 2 + 1 complex values -> n real values, normalized by 1 / n
+        void inverse(const complex* in, double* out) const;
+
+    private:
+        arg_type r_n;
+        std::shared_ptr<const Plan> r_half;
+        std::vector<complex> r_twiddles;      // e^{-2 pi i k / n}, k <= n / 2
+    };
+
+    // Transforms along one axis; every lane is an independent job spread over the thread pool
+    Array<complex> fft(const Array<complex>& arr, arg_type axis = -1);
+    Array<complex> ifft(const Array<complex>& arr, arg_type axis = -1);
+
+    template <typename T>
+    Array<complex> fft(const Array<T>& arr, arg_type axis = -1);
+
+    // Real transforms along the last axis
+    template <typename T>
+    Array<complex> rfft(const Array<T>& arr);
+    Array<double> irfft(const Array<complex>& arr, arg_type n = -1);
+
+    // Transforms over the last two axes
+    Array<complex> fft2(const Array<complex>& arr);
+    Array<complex> ifft2(const Array<complex>& arr);
+
+    template <typename T>
+    Array<complex> fft2(const Array<T>& arr);
+}
+
+#include "../templates/fft.ipp"
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "./numc_types.hpp"
+#include "./Shape.hpp"
 #include <vector>
 #include <cmath>
 
@@ -21,7 +22,7 @@ namespace SamH::NumC::Global
     struct Bitwise
     {
     private:
-        Bitwise() default;
+        Bitwise() = default;
         
         // --- STATIC UNARY HELPER ---
         template <typename T, typename Container, typename Op>
@@ -97,14 +98,21 @@ namespace SamH::NumC::Global
     template <typename T>
     Array<T> concatenate(const Array<T>& arr1, const Array<T>& arr2, arg_type axis = 0);
     
+    // Uninitialized storage for arrays that are about to be overwritten
     template <typename T>
-    Array<T> zeros(const std::vector<arg_type>& dims);
+    Array<T> empty(const Shape& dims);
+
+    template <typename T>
+    Array<T> empty_like(const Array<T>& arr);
+
+    template <typename T>
+    Array<T> zeros(const Shape& dims);
 
     template <typename T>
     Array<T> zeros_like(const Array<T>& arr);
 
     template <typename T>
-    Array<T> ones(const std::vector<arg_type>& dims);
+    Array<T> ones(const Shape& dims);
 
     template <typename T>
     Array<T> ones_like(const Array<T>& arr);
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./cumulative.hpp"
+#include "./parallel.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace SamH::NumC::Global
+{
+    // Distinct keys in ascending order and one aggregate per key. Multi-key results
+    // have keys of shape (groups, key columns), compared column by column.
+    template <typename K, typename V>
+    struct Grouped
+    {
+        Array<K> keys;
+        Array<V> values;
+    };
+
+    // Aggregates values by the key at the same flat position. Every thread aggregates
+    // its share into a private table, and the tables are merged by hash partition in
+    // parallel. Integer keys spanning a small range skip hashing and index their
+    // aggregates directly. Floating keys treat -0.0 as 0.0 and every NaN as one key,
+    // sorted last.
+    template <typename K, typename V>
+    Grouped<K, V> group_sum(const Array<K>& keys, const Array<V>& values);
+
+    template <typename K, typename V>
+    Grouped<K, double> group_mean(const Array<K>& keys, const Array<V>& values);
+
+    template <typename K, typename V>
+    Grouped<K, V> group_min(const Array<K>& keys, const Array<V>& values);
+
+    template <typename K, typename V>
+    Grouped<K, V> group_max(const Array<K>& keys, const Array<V>& values);
+
+    template <typename K>
+    Grouped<K, arg_type> group_count(const Array<K>& keys);
+
+    // Composite keys: one array per key column, all as long as the values
+    template <typename K, typename V>
+    Grouped<K, V> group_sum(const std::vector<Array<K>>& keys, const Array<V>& values);
+
+    template <typename K, typename V>
+    Grouped<K, double> group_mean(const std::vector<Array<K>>& keys, const Array<V>& values);
+
+    template <typename K, typename V>
+    Grouped<K, V> group_min(const std::vector<Array<K>>& keys, const Array<V>& values);
+
+    template <typename K, typename V>
+    Grouped<K, V> group_max(const std::vector<Array<K>>& keys, const Array<V>& values);
+
+    template <typename K>
+    Grouped<K, arg_type> group_count(const std::vector<Array<K>>& keys);
+
+    namespace detail
+    {
+        // Open-addressing hash table numbering distinct key rows (`width` values each)
+        // in insertion order. Slots hold only the hash and the id, so probing stays in
+        // a few cache lines; the keys themselves are packed in insertion order.
+        template <typename K>
+        class KeyTable
+        {
+            static_assert(std::is_arithmetic_v<K>, "KeyTable requires a numeric key type");
+
+        public:
+            explicit KeyTable(arg_type width = 1, arg_type expected = 0);
+
+            arg_type width() const { return k_width; }
+            arg_type size() const { return static_cast<arg_type>(k_hashes.size()); }
+
+            // Id of the key, added with the next id when new
+            arg_type insert(const K* key, std::uint64_t hash, bool& inserted);
+            // -1 when the key is absent
+            arg_type find(const K* key, std::uint64_t hash) const;
+
+            // Starts loading the slot a later insert or find of hash probes first
+            void prefetch(std::uint64_t hash) const;
+
+            const K* key(arg_type id) const { return k_keys.data() + id * k_width; }
+            std::uint64_t hash(arg_type id) const { return k_hashes[id]; }
+
+            void reserve(arg_type count);
+
+        private:
+            struct Slot
+            {
+                std::uint64_t hash;
+                arg_type id;            // -1 while empty
+            };
+
+            bool same(const Slot& slot, const K* key, std::uint64_t hash) const;
+            void rehash(std::size_t capacity);
+
+        private:
+            // A single key of at most 8 bytes is a bijection of its hash, so equal
+            // hashes already mean equal keys
+            bool k_exact;
+            arg_type k_width;
+            std::vector<Slot> k_slots;
+            std::size_t k_mask = 0;
+            std::vector<K> k_keys;
+            std::vector<std::uint64_t> k_hashes;
+        };
+
+        template <typename K>
+        std::uint64_t hash_key(const K* key, arg_type width);
+
+        template <typename K>
+        bool key_less(const K* a, const K* b, arg_type width);
+    }
+}
+
+#include "../templates/groupby.ipp"
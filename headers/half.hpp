@@ -0,0 +1,93 @@
+#pragma once
+
+#include "./numc_types.hpp"
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+
+#if defined(__F16C__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace SamH::NumC
+{
+    // IEEE 754 binary16: 1 sign, 5 exponent and 10 mantissa bits. Stored at half
+    // width, every operation converts to float and rounds back to nearest even.
+    class float16
+    {
+    public:
+        float16() = default;
+        float16(float value);
+
+        operator float() const;
+
+        float16& operator+=(float rhv);
+        float16& operator-=(float rhv);
+        float16& operator*=(float rhv);
+        float16& operator/=(float rhv);
+
+        std::uint16_t bits() const;
+        static float16 from_bits(std::uint16_t bits);
+
+    private:
+        std::uint16_t h_bits;
+    };
+
+    // Brain floating point: the upper half of a float, 8 exponent and 7 mantissa bits
+    class bfloat16
+    {
+    public:
+        bfloat16() = default;
+        bfloat16(float value);
+
+        operator float() const;
+
+        bfloat16& operator+=(float rhv);
+        bfloat16& operator-=(float rhv);
+        bfloat16& operator*=(float rhv);
+        bfloat16& operator/=(float rhv);
+
+        std::uint16_t bits() const;
+        static bfloat16 from_bits(std::uint16_t bits);
+
+    private:
+        std::uint16_t h_bits;
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, float16 value);
+    inline std::ostream& operator<<(std::ostream& out, bfloat16 value);
+
+    namespace detail
+    {
+        template <typename T>
+        constexpr bool is_half_v = std::is_same_v<T, float16> || std::is_same_v<T, bfloat16>;
+
+        // Half types compute in float, or in the wider floating type they meet
+        template <typename U>
+        using half_promote_t = std::conditional_t<std::is_floating_point_v<U>, std::common_type_t<float, U>, float>;
+
+        inline std::uint16_t float_to_half_bits(float value);
+        inline float half_bits_to_float(std::uint16_t bits);
+        inline std::uint16_t float_to_bfloat_bits(float value);
+        inline float bfloat_bits_to_float(std::uint16_t bits);
+
+        // Bulk conversions, vectorized with F16C / SSE2 where available
+        inline void widen(const float16* src, float* dst, arg_type n);
+        inline void widen(const bfloat16* src, float* dst, arg_type n);
+        inline void narrow(const float* src, float16* dst, arg_type n);
+        inline void narrow(const float* src, bfloat16* dst, arg_type n);
+    }
+
+    template <> struct promote_type<float16, float16>   { using type = float16; };
+    template <> struct promote_type<bfloat16, bfloat16> { using type = bfloat16; };
+    template <> struct promote_type<float16, bfloat16>  { using type = float; };
+    template <> struct promote_type<bfloat16, float16>  { using type = float; };
+
+    template <typename U> struct promote_type<float16, U>  { using type = detail::half_promote_t<U>; };
+    template <typename T> struct promote_type<T, float16>  { using type = detail::half_promote_t<T>; };
+    template <typename U> struct promote_type<bfloat16, U> { using type = detail::half_promote_t<U>; };
+    template <typename T> struct promote_type<T, bfloat16> { using type = detail::half_promote_t<T>; };
+}
+
+#include "../templates/half.ipp"
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+
+namespace SamH::NumC::detail
+{
+    // Every kernel sees the source as (outer, n, inner): `inner` contiguous values per
+    // position along the indexed axis. Flat indexing is outer = inner = 1.
+
+    // dst(o, j, :) = src(o, indices[j], :) for k indices
+    template <typename T>
+    void gather_rows(const T* src, arg_type outer, arg_type n, arg_type inner,
+                     const arg_type* indices, arg_type k, T* dst);
+
+    // dst(o, indices[j], :) op= values(o, j, :), or op= values[0] everywhere when
+    // broadcast. Destinations are split into disjoint ranges, one per task, so
+    // repeated indices never race and are applied in index order.
+    template <typename T, typename Op>
+    void scatter_rows(T* dst, arg_type outer, arg_type n, arg_type inner,
+                      const arg_type* indices, arg_type k, const T* values, bool broadcast, Op op);
+
+    // scatter_rows with +=. Small destinations get a private copy per task that is
+    // summed at the end, which avoids sorting the indices.
+    template <typename T>
+    void scatter_add_rows(T* dst, arg_type outer, arg_type n, arg_type inner,
+                          const arg_type* indices, arg_type k, const T* values, bool broadcast);
+}
+
+#include "../templates/indexing.ipp"
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include <type_traits>
+
+namespace SamH::NumC::Global::Linalg
+{
+    // Integer matrices are factored in double
+    template <typename T>
+    using work_type = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    // Operations on stacks of small matrices: the last two axes hold each matrix and
+    // every leading axis is a batch axis. Factorizations interleave a group of matrices
+    // so every arithmetic step runs across the group, one matrix per SIMD lane, and
+    // groups are spread over the thread pool.
+
+    // (..., k, k) -> (...), {1} for a single matrix
+    template <typename T>
+    Array<T> det(const Array<T>& arr);
+
+    // (..., k, k) -> (..., k, k); throws std::runtime_error if any matrix is singular
+    template <typename T>
+    Array<work_type<T>> inv(const Array<T>& arr);
+
+    // A x = b for (..., k, k) A and b of shape (..., k) or (..., k, m)
+    template <typename T>
+    Array<work_type<T>> solve(const Array<T>& a, const Array<T>& b);
+
+    // (..., k, m) x (..., m, p) -> (..., k, p); a 2-D operand is shared by the whole batch
+    template <typename T>
+    Array<T> matmul(const Array<T>& a, const Array<T>& b);
+}
+
+#include "../templates/linalg.ipp"
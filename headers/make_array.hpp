@@ -21,10 +21,11 @@ make_array_impl(const List& init)
     if constexpr (std::is_same_v<typename List::value_type, U>) {
         result.n_data.assign(init.begin(), init.end());
         result.n_dims = { static_cast<arg_type>(init.size()) };
+        result.update_strides();
     } else {
         // N-D recursive case
-        std::vector<U> flat;
-        std::vector<arg_type> dims;
+        typename Array<U>::storage_type flat;
+        Shape dims;
 
         for (auto& sublist : init) {
             auto subarray = make_array_impl<U>(sublist); // recurse
@@ -34,7 +35,8 @@ make_array_impl(const List& init)
 
         result.n_data = std::move(flat);    
         result.n_dims = { static_cast<arg_type>(init.size()) };
-        result.n_dims.insert(result.n_dims.end(), dims.begin(), dims.end());
+        for (auto d : dims) result.n_dims.push_back(d);
+        result.update_strides();
     }
 
     return result;
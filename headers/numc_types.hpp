@@ -2,9 +2,31 @@
 
 #include <cstdint>
 #include <cmath>
+#include <type_traits>
 
 namespace SamH::NumC {
     const double E = std::exp(1.0);
     const double PI = std::acos(-1.0);
     using arg_type = int64_t;  
+
+    // Element type of a binary operation between arrays of T and U
+    template <typename T, typename U>
+    struct promote_type { using type = std::common_type_t<T, U>; };
+
+    template <typename T, typename U>
+    using promote_t = typename promote_type<T, U>::type;
+
+    namespace detail
+    {
+        // One-letter element kind recorded with the width in columnar files and shared
+        // memory segments, so readers can refuse a mismatched element type
+        template <typename T>
+        constexpr char type_kind()
+        {
+            if constexpr (std::is_same_v<T, bool>)           return 'b';
+            else if constexpr (std::is_floating_point_v<T>)  return 'f';
+            else if constexpr (std::is_signed_v<T>)          return 'i';
+            else                                             return 'u';
+        }
+    }
 }
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "./numc_types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SamH::NumC::Parallel
+{
+    // Ranges shorter than this are not worth waking the pool for
+    constexpr arg_type DEFAULT_GRAIN = 1 << 15;
+
+    // ======================== THREAD POOL ========================
+    // Persistent workers shared by every parallel kernel. The calling thread takes part
+    // in each job, and a job started from inside another job runs serially.
+    class ThreadPool
+    {
+    public:
+        static ThreadPool& instance()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        // Worker threads plus the caller
+        arg_type size() const { return static_cast<arg_type>(p_workers.size()) + 1; }
+
+        // Runs task(0) ... task(tasks - 1) across the pool and blocks until all are done
+        template <typename F>
+        void run(arg_type tasks, F&& task)
+        {
+            if (tasks <= 0) return;
+            if (tasks == 1 || p_workers.empty() || in_job()) {
+                for (arg_type i = 0; i < tasks; ++i) task(i);
+                return;
+            }
+
+            std::lock_guard<std::mutex> job_lock(p_job_mutex);
+            Job job;
+            job.tasks = tasks;
+            job.func = [&task](arg_type i) { task(i); };
+            {
+                std::lock_guard<std::mutex> lock(p_mutex);
+                p_job = &job;
+                ++p_generation;
+            }
+            p_cv.notify_all();
+
+            in_job() = true;
+            work_on(job);
+            in_job() = false;
+
+            std::unique_lock<std::mutex> lock(p_mutex);
+            p_done_cv.wait(lock, [&] { return job.done == job.tasks && job.active == 0; });
+            p_job = nullptr;
+            lock.unlock();
+
+            if (job.error) std::rethrow_exception(job.error);
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(p_mutex);
+                p_stop = true;
+            }
+            p_cv.notify_all();
+            for (auto& worker : p_workers) worker.join();
+        }
+
+    private:
+        struct Job
+        {
+            std::function<void(arg_type)> func;
+            arg_type tasks = 0;
+            std::atomic<arg_type> next{0};
+            std::atomic<arg_type> done{0};
+            arg_type active = 0;            // guarded by p_mutex
+            std::exception_ptr error;       // guarded by p_mutex
+        };
+
+        // Pool size comes from NUMC_NUM_THREADS when set, hardware concurrency otherwise
+        ThreadPool()
+        {
+            arg_type hw = std::thread::hardware_concurrency();
+            if (const char* env = std::getenv("NUMC_NUM_THREADS")) hw = std::atoll(env);
+            hw = std::max<arg_type>(1, hw);
+            for (arg_type i = 1; i < hw; ++i) {
+                p_workers.emplace_back([this] { worker_loop(); });
+            }
+        }
+
+        static bool& in_job()
+        {
+            thread_local bool flag = false;
+            return flag;
+        }
+
+        void work_on(Job& job)
+        {
+            arg_type i;
+            while ((i = job.next.fetch_add(1)) < job.tasks) {
+                try {
+                    job.func(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(p_mutex);
+                    if (!job.error) job.error = std::current_exception();
+                }
+                if (job.done.fetch_add(1) + 1 == job.tasks) {
+                    std::lock_guard<std::mutex> lock(p_mutex);
+                    p_done_cv.notify_all();
+                }
+            }
+        }
+
+        void worker_loop()
+        {
+            in_job() = true;
+            std::uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock(p_mutex);
+            while (true) {
+                p_cv.wait(lock, [&] { return p_stop || p_generation != seen; });
+                if (p_stop) return;
+                seen = p_generation;
+                Job* job = p_job;
+                if (job == nullptr) continue;
+
+                ++job->active;
+                lock.unlock();
+                work_on(*job);
+                lock.lock();
+                --job->active;
+                p_done_cv.notify_all();
+            }
+        }
+
+    private:
+        std::vector<std::thread> p_workers;
+        std::mutex p_job_mutex;
+        std::mutex p_mutex;
+        std::condition_variable p_cv;
+        std::condition_variable p_done_cv;
+        Job* p_job = nullptr;
+        std::uint64_t p_generation = 0;
+        bool p_stop = false;
+    };
+
+    // ======================== SETTINGS ========================
+    inline arg_type& thread_limit()
+    {
+        static arg_type limit = ThreadPool::instance().size();
+        return limit;
+    }
+
+    // Number of threads parallel kernels may use
+    inline arg_type num_threads() { return std::min(thread_limit(), ThreadPool::instance().size()); }
+
+    inline void set_num_threads(arg_type count) { thread_limit() = std::max<arg_type>(1, count); }
+
+    // ======================== LOOPS ========================
+    // How many chunks of at least `grain` elements [0, count) is split into
+    inline arg_type chunk_count(arg_type count, arg_type grain = DEFAULT_GRAIN)
+    {
+        if (count <= 0) return 0;
+        const arg_type by_size = (count + grain - 1) / std::max<arg_type>(1, grain);
+        return std::max<arg_type>(1, std::min(num_threads(), by_size));
+    }
+
+    // Splits [begin, end) into `chunks` contiguous pieces and calls func(chunk, chunk_begin, chunk_end)
+    template <typename F>
+    void parallel_chunks(arg_type begin, arg_type end, arg_type chunks, F&& func)
+    {
+        const arg_type count = end - begin;
+        if (count <= 0 || chunks <= 0) return;
+        ThreadPool::instance().run(chunks, [&](arg_type c) {
+            const arg_type b = begin + count * c / chunks;
+            const arg_type e = begin + count * (c + 1) / chunks;
+            if (b < e) func(c, b, e);
+        });
+    }
+
+    // Calls func(chunk_begin, chunk_end) over [begin, end), in parallel when the range is large enough
+    template <typename F>
+    void parallel_for(arg_type begin, arg_type end, F&& func, arg_type grain = DEFAULT_GRAIN)
+    {
+        const arg_type chunks = chunk_count(end - begin, grain);
+        if (chunks <= 1) {
+            if (begin < end) func(begin, end);
+            return;
+        }
+        parallel_chunks(begin, end, chunks, [&](arg_type, arg_type b, arg_type e) { func(b, e); });
+    }
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace SamH::NumC::Pipeline
+{
+    enum Op
+    {
+        INPUT,
+        CONSTANT,
+        IDENTITY,
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        NEGATE,
+        EXP,
+        LOG,
+        SQRT,
+        ABS,
+        GREATER,
+        LESS,
+        EQUAL,
+        WHERE,
+        SUM
+    };
+
+    struct StageTiming
+    {
+        std::string name;
+        arg_type runs;
+        double total_ms;
+    };
+
+    // A recorded sequence of operations on fixed input shapes. Recording resolves
+    // broadcasting once; compile() fuses chains of elementwise operations into single
+    // passes, drops unused results and assigns intermediate buffers by lifetime so
+    // results that are no longer needed hand their memory to later ones. run() replays
+    // the plan on new inputs without allocating.
+    template <typename T>
+    class Plan
+    {
+    public:
+        using Handle = arg_type;
+
+        Handle input(const Shape& shape);
+        Handle constant(T value);
+
+        Handle add(Handle a, Handle b);
+        Handle subtract(Handle a, Handle b);
+        Handle multiply(Handle a, Handle b);
+        Handle divide(Handle a, Handle b);
+
+        Handle negate(Handle a);
+        Handle exp(Handle a);
+        Handle log(Handle a);
+        Handle sqrt(Handle a);
+        Handle abs(Handle a);
+
+        // Comparisons give T(1) / T(0), where() picks x wherever condition != 0
+        Handle greater(Handle a, Handle b);
+        Handle less(Handle a, Handle b);
+        Handle equal(Handle a, Handle b);
+        Handle where(Handle condition, Handle x, Handle y);
+
+        // Sum of every element, shape {1}
+        Handle sum(Handle a);
+
+        // Marks a node as a result, returns its index for result()
+        arg_type output(Handle node);
+
+        void compile();
+        bool compiled() const;
+
+        // Inputs in the order they were declared; compiles on first use
+        template <typename... Arrays>
+        void run(const Arrays&... inputs);
+        void run(const Array<T>* const* inputs, arg_type count);
+
+        const Array<T>& result(arg_type index) const;
+
+        // Fused passes and distinct intermediate buffers after compile()
+        arg_type step_count() const;
+        arg_type buffer_count() const;
+
+        std::vector<StageTiming> timings() const;
+        void reset_timings();
+        void print_timings() const;
+
+    private:
+        struct Node
+        {
+            Op op;
+            std::array<Handle, 3> args;
+            arg_type arity;
+            T value;
+            Shape shape;
+        };
+
+        enum Source
+        {
+            FROM_STAGE,
+            FROM_INPUT,
+            FROM_BUFFER,
+            FROM_OUTPUT,
+            FROM_CONSTANT
+        };
+
+        // Where a stage reads one argument from, with strides broadcast into the step's shape
+        struct Operand
+        {
+            Source source;
+            arg_type index;
+            T value;
+            Shape strides;
+            bool contiguous;
+        };
+
+        struct Stage
+        {
+            Op op;
+            std::array<Operand, 3> args;
+            arg_type arity;
+        };
+
+        struct Step
+        {
+            std::string name;
+            Shape shape;
+            arg_type total;
+            std::vector<Stage> stages;      // topological, the last one is the root
+            bool reduce;
+            Source target;
+            arg_type target_index;
+            arg_type runs;
+            double seconds;
+        };
+
+    private:
+        Handle record(Op op, std::initializer_list<Handle> args, const Shape& shape, T value = T());
+        Handle elementwise(Op op, std::initializer_list<Handle> args);
+        const Node& node(Handle handle) const;
+
+        bool is_elementwise(Op op) const;
+        Operand leaf(Handle handle, const Shape& shape) const;
+        arg_type collect(Handle handle, const std::vector<bool>& fused, const Shape& shape, Step& step) const;
+
+        const T* source_data(Source source, arg_type index) const;
+        void execute(Step& step);
+
+    private:
+        std::vector<Node> p_nodes;
+        std::vector<Shape> p_input_shapes;
+        std::vector<Handle> p_outputs;
+
+        bool p_compiled = false;
+        std::vector<Step> p_steps;
+        std::vector<arg_type> p_location;     // buffer / output index of every materialized node
+        std::vector<Source> p_kind;
+        std::vector<typename Array<T>::storage_type> p_buffers;
+        std::vector<Array<T>> p_results;
+        std::vector<T> p_scratch;             // per-chunk block registers
+        std::vector<T> p_partial;             // per-chunk partial sums
+        arg_type p_scratch_stride = 0;
+
+        const Array<T>* const* p_inputs = nullptr;
+    };
+}
+
+#include "../templates/plan.ipp"
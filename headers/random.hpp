@@ -342,46 +342,7 @@ namespace SamH::NumC::Random
         };
         return generate_array_broadcast<double>(make_dist, size);
     }
-
-    // ======================== SHUFFLE ========================
-    void shuffle(Array<int>& arr) {
-        std::mt19937& eng = get_engine();
-        for (arg_type i = arr.size() - 1; i > 0; --i) {
-            std::uniform_int_distribution<arg_type> dist(0, i);
-            arg_type j = dist(eng);
-            std::swap(arr[i], arr[j]);
-        }
-    }
-
-    // ======================== PERMUTATION ========================
-    Array<int> permutation(const Array<int>& arr) {
-        Array<int> result = arr;
-        shuffle(result);
-        return result;
-    }
-
-    // ======================== CHOICE ========================
-    Array<int> choice(const std::vector<int>& a,
-                      const std::vector<arg_type>& size,
-                      bool replace=true)
-    {
-        arg_type total = compute_total(size);
-        Array<int> result(total);
-        result.reshape(size);
-
-        std::mt19937& eng = get_engine();
-
-        if (replace) {
-            std::uniform_int_distribution<arg_type> dist(0, a.size() - 1);
-            for (arg_type i = 0; i < total; ++i)
-                result[i] = a[dist(eng)];
-        } else {
-            std::vector<int> pool = a;
-            std::shuffle(pool.begin(), pool.end(), eng);
-            for (arg_type i = 0; i < total; ++i)
-                result[i] = pool[i % pool.size()];
-        }
-
-        return result;
-    }
 }
+
+// shuffle, permutation and choice, along with the other samplers
+#include "./sampling.hpp"
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./cumulative.hpp"
+#include "./parallel.hpp"
+
+namespace SamH::NumC::Global
+{
+    // Sliding-window statistics along one axis. Result position k covers
+    // arr[k .. k + window) on that axis, so the axis shrinks to len - window + 1.
+    // Every statistic is updated incrementally, O(1) amortized per step whatever the
+    // window. Long series are split across threads; each piece starts window - 1
+    // values early to fill its first window.
+
+    // Compensated (Neumaier) running sum for floating types, exact for integers
+    template <typename T>
+    Array<T> rolling_sum(const Array<T>& arr, arg_type window, arg_type axis = -1);
+
+    template <typename T>
+    Array<double> rolling_mean(const Array<T>& arr, arg_type window, arg_type axis = -1);
+
+    // Welford updates on every slide; divides by window - ddof (population by default,
+    // like Array::var)
+    template <typename T>
+    Array<double> rolling_var(const Array<T>& arr, arg_type window, arg_type axis = -1, arg_type ddof = 0);
+
+    template <typename T>
+    Array<double> rolling_std(const Array<T>& arr, arg_type window, arg_type axis = -1, arg_type ddof = 0);
+
+    // Monotonic deque of candidate positions, each value enters and leaves it once
+    template <typename T>
+    Array<T> rolling_min(const Array<T>& arr, arg_type window, arg_type axis = -1);
+
+    template <typename T>
+    Array<T> rolling_max(const Array<T>& arr, arg_type window, arg_type axis = -1);
+}
+
+#include "../templates/rolling.ipp"
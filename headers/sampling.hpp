@@ -0,0 +1,103 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include "./random.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace SamH::NumC::Random
+{
+    // Walker's alias method (Vose's construction): O(n) to build, then every draw costs
+    // one random number and one table lookup. Build once per weight vector and reuse.
+    class AliasTable
+    {
+    public:
+        AliasTable() = default;
+        explicit AliasTable(const std::vector<double>& weights);
+
+        template <typename T>
+        explicit AliasTable(const Array<T>& weights);
+
+        arg_type size() const;
+
+        // One index drawn with probability weights[i] / sum(weights)
+        template <typename Engine>
+        arg_type operator()(Engine& engine) const;
+
+        // Fills out with independent draws across the thread pool
+        void sample(arg_type* out, arg_type count) const;
+        Array<arg_type> sample(arg_type count) const;
+
+    private:
+        void build(std::vector<double> weights);
+
+    private:
+        std::vector<double> a_threshold;     // chance of keeping the bucket's own index
+        std::vector<arg_type> a_alias;
+    };
+
+    // k distinct indices from [0, n) in random order. Floyd's algorithm with a hash set
+    // when k is small next to n, a partial Fisher-Yates shuffle otherwise.
+    inline Array<arg_type> sample_indices(arg_type n, arg_type k);
+
+    // k distinct indices drawn in turn with probability proportional to the weights of the
+    // ones still left (Efraimidis-Spirakis keys)
+    inline Array<arg_type> sample_indices(const std::vector<double>& weights, arg_type k);
+
+    // Uniform sample of up to `capacity` items from a stream of unknown length, fed one
+    // value or one chunk at a time. Uses Algorithm L, so the random numbers drawn grow
+    // with capacity * log(seen / capacity) rather than with the stream length.
+    template <typename T>
+    class Reservoir
+    {
+    public:
+        explicit Reservoir(arg_type capacity);
+
+        void add(const T& value);
+        void add(const T* values, arg_type count);
+        void add(const Array<T>& chunk);
+
+        arg_type capacity() const;
+        arg_type seen() const;
+
+        // min(capacity, seen) values, 1-D
+        Array<T> sample() const;
+
+    private:
+        void advance();
+
+    private:
+        arg_type r_capacity;
+        arg_type r_seen = 0;
+        arg_type r_next = 0;        // stream position of the next value to take in
+        double r_weight = 0.0;
+        std::vector<T> r_items;
+        std::mt19937_64 r_engine;
+    };
+
+    // Uniform in-place permutation. Large arrays are scattered into random buckets and
+    // the buckets are shuffled in parallel.
+    template <typename T>
+    void shuffle(Array<T>& arr);
+
+    template <typename T>
+    Array<T> permutation(const Array<T>& arr);
+    inline Array<arg_type> permutation(arg_type n);
+
+    // Elements of a in the given shape, uniformly or with probabilities p
+    template <typename T>
+    Array<T> choice(const std::vector<T>& a, const std::vector<arg_type>& size, bool replace = true);
+
+    template <typename T>
+    Array<T> choice(const std::vector<T>& a, const std::vector<arg_type>& size,
+                    const std::vector<double>& p, bool replace = true);
+
+    // Braced lists such as choice({1, 2, 3}, {2}) can't deduce T, so int keeps its own overloads
+    inline Array<int> choice(const std::vector<int>& a, const std::vector<arg_type>& size, bool replace = true);
+    inline Array<int> choice(const std::vector<int>& a, const std::vector<arg_type>& size,
+                             const std::vector<double>& p, bool replace = true);
+}
+
+#include "../templates/sampling.ipp"
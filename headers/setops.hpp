@@ -0,0 +1,36 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./Mask.hpp"
+#include "./groupby.hpp"
+#include "./parallel.hpp"
+
+namespace SamH::NumC::Global
+{
+    // Set operations on flattened arrays. Values compare like group_by keys: -0.0
+    // equals 0.0, NaN equals NaN and sorts after every number.
+
+    // Whether every element of arr occurs in test (or doesn't, with invert), one flag per
+    // flat position. The test set is a bitmap when it holds integers over a small range,
+    // a merge walk when both arrays are already sorted, and a hash table behind a
+    // blocked Bloom filter otherwise. Probing arr runs in parallel.
+    template <typename T>
+    Mask isin(const Array<T>& arr, const Array<T>& test, bool invert = false);
+
+    template <typename T>
+    Mask in1d(const Array<T>& arr, const Array<T>& test, bool invert = false);
+
+    // Sorted distinct values found in both, in either, or in a but not in b. Inputs
+    // that are already sorted and distinct are merged directly; others are reduced to
+    // their distinct values first with the group_by tables.
+    template <typename T>
+    Array<T> intersect1d(const Array<T>& a, const Array<T>& b);
+
+    template <typename T>
+    Array<T> union1d(const Array<T>& a, const Array<T>& b);
+
+    template <typename T>
+    Array<T> setdiff1d(const Array<T>& a, const Array<T>& b);
+}
+
+#include "../templates/setops.ipp"
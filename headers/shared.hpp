@@ -0,0 +1,223 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./Viewer.hpp"
+#include "./parallel.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace SamH::NumC::Shared
+{
+    // Segment layout: a fixed header ("NUMCSHM1", element type, shape) padded to
+    // STORAGE_ALIGNMENT, then the values in row-major order and native byte order.
+    // Named segments live in /dev/shm and outlast their creator until unlink();
+    // anonymous ones are memfds, handed to other processes by fork or SCM_RIGHTS.
+    constexpr arg_type MAX_DIMS = 16;
+
+    namespace detail
+    {
+        struct SegmentHeader
+        {
+            char magic[8];
+            char kind;                  // type_kind of the element type
+            char width;                 // sizeof the element type
+            char reserved[2];
+            std::uint32_t ndim;
+            std::uint64_t data_offset;
+            std::uint64_t data_bytes;
+            std::int64_t dims[MAX_DIMS];
+        };
+
+        // One mapping of a shared memory object, unmapped and closed on destruction
+        class Mapping
+        {
+        public:
+            Mapping() = default;
+            Mapping(int fd, std::size_t bytes, bool writable);
+            Mapping(Mapping&& rhv) noexcept;
+            Mapping& operator=(Mapping&& rhv) noexcept;
+            ~Mapping();
+
+            Mapping(const Mapping&) = delete;
+            Mapping& operator=(const Mapping&) = delete;
+
+            char* data() const { return m_data; }
+            std::size_t bytes() const { return m_bytes; }
+            int fd() const { return m_fd; }
+            bool writable() const { return m_writable; }
+
+        private:
+            void release() noexcept;
+
+        private:
+            char* m_data = nullptr;
+            std::size_t m_bytes = 0;
+            int m_fd = -1;
+            bool m_writable = false;
+        };
+    }
+
+    // Array<T> whose values live in shared memory. The creator maps it read-write;
+    // attach() maps it read-only in another process without copying. Only trivially
+    // copyable element types can be shared.
+    template <typename T>
+    class SharedArray
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SharedArray requires a trivially copyable element type");
+
+    public:
+        using Slice = typename Array<T>::Slice;
+
+        SharedArray() = default;
+
+        // New named segment ("/name"), zero-filled or holding a copy of values.
+        // Throws std::runtime_error when the name is taken.
+        static SharedArray create(const std::string& name, const Shape& shape);
+        static SharedArray create(const std::string& name, const Array<T>& values);
+
+        // New memfd segment; pass fd() to the other process and attach(fd) there
+        static SharedArray create_anonymous(const Shape& shape);
+        static SharedArray create_anonymous(const Array<T>& values);
+
+        // Read-only mapping of an existing segment; the element type must match
+        static SharedArray attach(const std::string& name);
+        static SharedArray attach(int fd);
+
+        // Removes the name, mappings already made stay valid
+        static void unlink(const std::string& name);
+
+        arg_type size() const;
+        const Shape& shape() const;
+        bool writable() const;
+        int fd() const;
+
+        const T* data() const;
+        // Writable pointer for the creator, throws std::runtime_error on a read-only attachment
+        T* mutable_data();
+
+        // Zero-copy writable view for the creator, throws std::runtime_error on a read-only
+        // attachment
+        Viewer<T> view();
+        Viewer<T> view(const std::vector<Slice>& slices);
+
+        // Zero-copy read-only view, for attached segments as much as created ones
+        ConstViewer<T> const_view() const;
+        ConstViewer<T> const_view(const std::vector<Slice>& slices) const;
+
+        // Private copy into ordinary memory
+        Array<T> copy() const;
+
+    private:
+        static SharedArray create_in(int fd, const Shape& shape);
+        static SharedArray attach_to(int fd);
+
+    private:
+        detail::Mapping s_mapping;
+        Shape s_shape;
+        T* s_data = nullptr;
+        arg_type s_size = 0;
+    };
+
+    // Bounded single-producer / multi-consumer queue of arrays in one shared segment.
+    // Every slot holds up to slot_shape[0] rows of slot_shape[1:]; each pushed batch
+    // goes to exactly one consumer. Push and pop are lock-free (one CAS per pop) and
+    // a popped batch is read in place, its slot is recycled when the Batch is dropped.
+    // Blocking calls spin briefly, then sleep on a futex in the slot they wait for.
+    template <typename T>
+    class SharedRing
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SharedRing requires a trivially copyable element type");
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                      "SharedRing requires lock-free 64-bit atomics");
+
+        struct Header;
+        struct SlotHeader;
+
+    public:
+        // A popped slot, released back to the producer on destruction. Must not outlive
+        // the ring it came from.
+        class Batch
+        {
+        public:
+            Batch() = default;
+            Batch(Batch&& rhv) noexcept;
+            Batch& operator=(Batch&& rhv) noexcept;
+            ~Batch();
+
+            Batch(const Batch&) = delete;
+            Batch& operator=(const Batch&) = delete;
+
+            explicit operator bool() const { return b_data != nullptr; }
+
+            const T* data() const { return b_data; }
+            const Shape& shape() const { return b_shape; }
+            arg_type size() const;
+            Array<T> copy() const;
+
+            // Hands the slot back before destruction
+            void release();
+
+        private:
+            friend class SharedRing;
+            Batch(SlotHeader* slot, std::uint64_t next, const T* data, Shape shape);
+
+        private:
+            SlotHeader* b_slot = nullptr;
+            std::uint64_t b_next = 0;
+            const T* b_data = nullptr;
+            Shape b_shape;
+        };
+
+        SharedRing() = default;
+
+        static SharedRing create(const std::string& name, arg_type slots, const Shape& slot_shape);
+        static SharedRing create_anonymous(arg_type slots, const Shape& slot_shape);
+        static SharedRing attach(const std::string& name);
+        static SharedRing attach(int fd);
+        static void unlink(const std::string& name);
+
+        arg_type slots() const;
+        const Shape& slot_shape() const;
+        int fd() const;
+
+        // ----------------- PRODUCER -----------------
+        // Copies batch into the next slot; false when every slot is still in use.
+        // batch has the slot shape, or fewer rows for a partial batch.
+        bool try_push(const Array<T>& batch);
+        // Waits for a free slot; false when the ring has been closed
+        bool push(const Array<T>& batch);
+
+        // In-place alternative to push: fill the slot, then publish how many rows it holds
+        T* try_reserve();
+        void publish(arg_type rows);
+
+        // No more batches; consumers drain what is queued and then get an empty Batch
+        void close();
+        bool closed() const;
+
+        // ----------------- CONSUMERS -----------------
+        // Empty Batch when nothing is queued
+        Batch try_pop();
+        // Waits for a batch; empty once the ring is closed and drained
+        Batch pop();
+
+    private:
+        static SharedRing create_in(int fd, arg_type slots, const Shape& slot_shape);
+        static SharedRing attach_to(int fd);
+
+        SlotHeader* slot(std::uint64_t position) const;
+        T* slot_data(SlotHeader* header) const;
+
+    private:
+        detail::Mapping r_mapping;
+        Header* r_header = nullptr;
+        Shape r_slot_shape;
+        arg_type r_row_size = 0;
+        bool r_reserved = false;
+    };
+}
+
+#include "../templates/shared.ipp"
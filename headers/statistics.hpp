@@ -0,0 +1,85 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include <vector>
+#include <cstdint>
+
+namespace SamH::NumC::Global
+{
+    struct Histogram
+    {
+        Array<arg_type> counts;
+        Array<double> edges;
+    };
+
+    // Occurrences of every non-negative integer value, counted in per-thread private bins
+    template <typename T>
+    Array<arg_type> bincount(const Array<T>& arr, arg_type minlength = 0);
+
+    // Sum of weights per value instead of plain counts
+    template <typename T, typename W>
+    Array<W> bincount(const Array<T>& arr, const Array<W>& weights, arg_type minlength = 0);
+
+    // Uniform bins over [min, max] of the data, or over [low, high]
+    template <typename T>
+    Histogram histogram(const Array<T>& arr, arg_type bins = 10);
+
+    template <typename T>
+    Histogram histogram(const Array<T>& arr, arg_type bins, double low, double high);
+
+    // Arbitrary increasing bin edges
+    template <typename T>
+    Histogram histogram(const Array<T>& arr, const Array<double>& edges);
+
+    // Index of the bin each value falls into, bins must be increasing
+    template <typename T>
+    Array<arg_type> digitize(const Array<T>& arr, const Array<T>& bins, bool right = false);
+
+    // Linear-interpolated quantiles found by selection, q in [0, 1]
+    template <typename T>
+    double quantile(const Array<T>& arr, double q);
+
+    template <typename T>
+    Array<double> quantile(const Array<T>& arr, const Array<double>& q);
+
+    // Same as quantile with p in [0, 100]
+    template <typename T>
+    double percentile(const Array<T>& arr, double p);
+
+    template <typename T>
+    Array<double> percentile(const Array<T>& arr, const Array<double>& p);
+
+    // Mergeable streaming sketch for approximate quantiles (KLL compactor hierarchy).
+    // Memory stays O(k log(n / k)); rank error is roughly 1.7 / k.
+    template <typename T>
+    class QuantileSketch
+    {
+    public:
+        explicit QuantileSketch(arg_type k = 200);
+
+        void update(const T& value);
+        void update(const Array<T>& values);
+        void merge(const QuantileSketch& other);
+
+        T quantile(double q) const;
+        Array<T> quantile(const Array<double>& q) const;
+
+        arg_type count() const;
+        arg_type retained() const;
+
+    private:
+        arg_type capacity(std::size_t level) const;
+        void compress();
+        bool coin();
+
+    private:
+        arg_type q_k;
+        arg_type q_count;
+        arg_type q_retained;
+        std::uint64_t q_state;
+        std::vector<std::vector<T>> q_levels;
+    };
+}
+
+#include "../templates/statistics.ipp"
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "./numc_types.hpp"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace SamH::NumC
+{
+    // Every array buffer starts on a cache line
+    constexpr std::size_t STORAGE_ALIGNMENT = 64;
+
+    namespace Storage
+    {
+        constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+        enum HugePages
+        {
+            NONE,           // regular pages only
+            TRANSPARENT,    // huge-page aligned and madvise(MADV_HUGEPAGE)
+            EXPLICIT        // mmap(MAP_HUGETLB) from the reserved pool, TRANSPARENT when it is exhausted
+        };
+
+        // Process-wide policy for buffers of at least huge_page_threshold() bytes.
+        // Initialized from NUMC_HUGE_PAGES (none / transparent / explicit), TRANSPARENT by default.
+        inline HugePages huge_pages();
+        inline void set_huge_pages(HugePages policy);
+
+        inline std::size_t huge_page_threshold();
+        inline void set_huge_page_threshold(std::size_t bytes);
+
+        // Raw buffer aligned to STORAGE_ALIGNMENT, following the huge page policy
+        inline void* allocate(std::size_t bytes);
+        inline void deallocate(void* ptr) noexcept;
+    }
+
+    // Allocator behind Array storage. Elements are default-initialized, so resizing
+    // leaves trivially constructible values untouched: pages are only faulted in by the
+    // first write, which Array spreads across the thread pool.
+    template <typename T>
+    class AlignedAllocator
+    {
+    public:
+        using value_type = T;
+
+        AlignedAllocator() noexcept = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n);
+        void deallocate(T* ptr, std::size_t n) noexcept;
+
+        template <typename U>
+        void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>);
+
+        template <typename U, typename... Args>
+        void construct(U* ptr, Args&&... args);
+    };
+
+    template <typename T, typename U>
+    bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) noexcept { return true; }
+
+    template <typename T, typename U>
+    bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) noexcept { return false; }
+}
+
+#include "../templates/storage.ipp"
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "./Array.hpp"
+#include "./parallel.hpp"
+#include <string>
+
+namespace SamH::NumC::Global
+{
+    // Arrays with more than `threshold` elements print only `edge_items` rows and
+    // columns at each end. Floating values use `precision` significant digits.
+    struct PrintOptions
+    {
+        arg_type threshold = 1000;
+        arg_type edge_items = 3;
+        int precision = 6;
+    };
+
+    inline PrintOptions print_options();
+    inline void set_print_options(const PrintOptions& options);
+
+    // Numeric text with one row per line. Files are memory-mapped, split at line
+    // boundaries and parsed in parallel straight into the result. Blank lines and lines
+    // starting with `comments` are ignored. A single row or column gives a 1-D array.
+    // A blank delimiter splits on runs of spaces and tabs.
+    template <typename T>
+    Array<T> loadtxt(const std::string& path, char delimiter = ',', arg_type skip_rows = 0, char comments = '#');
+
+    // One line per row of the last axis. A negative precision writes the shortest text
+    // that reads back to the same value.
+    template <typename T>
+    void savetxt(const std::string& path, const Array<T>& arr, char delimiter = ',', int precision = -1);
+}
+
+#include "../templates/text_io.ipp"
@@ -11,8 +11,9 @@ namespace SamH::NumC
 template <typename T>
 Array<T>::Array(arg_type size, const T& elem)
     : n_data(size, elem)
+    , n_dims{size}
 {
-    n_dims.push_back(size);
+    update_strides();
 }
 
 template <typename T>
@@ -20,22 +21,44 @@ Array<T>::Array(const T* arr, const arg_type len)
 {
     for (arg_type i = 0; i < len; ++i) { n_data.push_back(arr[i]); }
     n_dims.push_back(len);
+    update_strides();
 }
 
 template <typename T>
 Array<T>::Array(const std::vector<T>& vector) 
-    : n_data(vector)
+    : n_data(vector.begin(), vector.end())
 {
     n_dims.push_back(vector.size());
+    update_strides();
+}
+
+template <typename T>
+Array<T>::Array(const Shape& shape, T fill)
+    : n_dims(shape)
+{
+    update_strides();
+    if constexpr (std::is_same_v<T, bool>) {
+        n_data.assign(shape.total(), fill);
+    } else {
+        // Allocation leaves the pages untouched; filling in parallel first-touches every
+        // chunk on the thread (and NUMA node) that later works on it
+        n_data.resize(shape.total());
+        T* dst = n_data.data();
+        Parallel::parallel_for(0, size(), [&](arg_type b, arg_type e) {
+            std::fill(dst + b, dst + e, fill);
+        });
+    }
 }
 
 template <typename T>
-Array<T>::Array(const std::vector<arg_type>& shape, T fill)
+Array<T>
+Array<T>::uninitialized(const Shape& shape)
 {
-    arg_type d = 1;
-    for (auto& i : shape) d *= i;
-    n_data = std::vector<T>(d, fill);
-    n_dims = shape;
+    Array<T> res;
+    res.n_dims = shape;
+    res.update_strides();
+    res.n_data.resize(shape.total());
+    return res;
 }
 
 template <typename T>
@@ -44,83 +67,136 @@ Array<T>::Array(const T *from, const T *to)
     arg_type size = 0;
     for (T* i = from; i != to; ++i, ++size) { n_data.push_back(*i); }
     n_dims.push_back(size);
+    update_strides();
 }
 
 template <typename T>
 Array<T>::Array(const Array& rhv)
     : n_data(rhv.n_data)
     , n_dims(rhv.n_dims)
+    , n_strides(rhv.n_strides)
 {}
 
+template <typename T>
+Array<T>::Array(Array&& rhv) noexcept
+    : n_data(std::move(rhv.n_data))
+    , n_dims(rhv.n_dims)
+    , n_strides(rhv.n_strides)
+{
+    rhv.reset_empty();
+}
+
 template <typename T>
 Array<T>::Array(const std::initializer_list<T> &init)
 {
     n_data.insert(n_data.end(), init.begin(), init.end());
     n_dims.push_back(init.size());
+    update_strides();
 }
 
 template <typename T>
 Array<T>::Array(const Viewer<T>& view)
+    : n_dims(view.shape)
 {
-    arg_type total_size = 1;
-    for (const auto& slice : view.views) {
-        arg_type current_dim_size = slice.size();
-        
-        if (current_dim_size == 0) {
-            total_size = 0;
-            break;
-        }
-        total_size *= current_dim_size;
-        this->n_dims.push_back(current_dim_size);
-    }
-
-    if (total_size == 0) {
-        return;
-    }
-
-    this->n_data.reserve(total_size);
-
-    std::vector<arg_type> coords(view.views.size(), 0);
-    for (arg_type i = 0; i < total_size; ++i) {
-        this->n_data.push_back(view(coords));
-
-        for (int j = n_dims.size() - 1; j >= 0; --j) {
-            coords[j]++;
-            if (coords[j] < n_dims[j]) {
-                break;
-            }
-            coords[j] = 0;
-        }
-    }
+    update_strides();
+    n_data.resize(view.size());
+    view.copy_to(n_data.data());
 }
 
 // NON-CONST slicing operator (returns a read/write proxy)
 template <typename T>
 Viewer<T>
 Array<T>::operator()(const std::vector<Slice>& slices) {
-    Viewer<T> view(n_data.data(), n_data.data() + n_data.size(), n_dims);
-    for (std::size_t d = 0; d < slices.size(); ++d) {
-        Slice s = slices[d];
-        s.normalize(n_dims[d]);   // adjust negatives relative to this dimension
-        view.views.push_back(s);
+    if (slices.size() > n_dims.size()) {
+        throw std::invalid_argument("Too many slices for the array's dimensions.");
+    }
+    std::vector<Slice> normalized(slices);
+    for (std::size_t d = 0; d < normalized.size(); ++d) {
+        normalized[d].normalize(n_dims[d]);   // adjust negatives relative to this dimension
     }
-    return view;
+    return Viewer<T>(n_data.data(), n_data.data() + n_data.size(), n_dims, normalized);
 }
 
 // CONST slicing operator (returns a new Array, read-only)
 template <typename T>
 Array<T> 
 Array<T>::operator()(const std::vector<Slice>& slices) const {
-    Viewer<T> view(const_cast<T*>(n_data.data()), 
-                   const_cast<T*>(n_data.data() + n_data.size()), n_dims);
-    for (std::size_t d = 0; d < slices.size(); ++d) {
-        Slice s = slices[d];
-        s.normalize(n_dims[d]);   // adjust negatives relative to this dimension
-        view.views.push_back(s);
+    if (slices.size() > n_dims.size()) {
+        throw std::invalid_argument("Too many slices for the array's dimensions.");
     }
+    std::vector<Slice> normalized(slices);
+    for (std::size_t d = 0; d < normalized.size(); ++d) {
+        normalized[d].normalize(n_dims[d]);   // adjust negatives relative to this dimension
+    }
+    Viewer<T> view(const_cast<T*>(n_data.data()), 
+                   const_cast<T*>(n_data.data() + n_data.size()), n_dims, normalized);
     return Array<T>(view); // Uses the constructor we defined above
 }
 
+template <typename T>
+Viewer<T>
+Array<T>::full_view() const
+{
+    return Viewer<T>(const_cast<T*>(n_data.data()),
+                     const_cast<T*>(n_data.data() + n_data.size()), n_dims);
+}
+
+template <typename T>
+Viewer<T>
+Array<T>::transpose()
+{
+    return full_view().transpose();
+}
+
+template <typename T>
+Viewer<T>
+Array<T>::transpose(const Shape& axes)
+{
+    return full_view().transpose(axes);
+}
+
+template <typename T>
+Viewer<T>
+Array<T>::swapaxes(arg_type first, arg_type second)
+{
+    return full_view().swapaxes(first, second);
+}
+
+template <typename T>
+Viewer<T>
+Array<T>::moveaxis(arg_type source, arg_type destination)
+{
+    return full_view().moveaxis(source, destination);
+}
+
+template <typename T>
+Array<T>
+Array<T>::transpose() const
+{
+    return Array<T>(full_view().transpose());
+}
+
+template <typename T>
+Array<T>
+Array<T>::transpose(const Shape& axes) const
+{
+    return Array<T>(full_view().transpose(axes));
+}
+
+template <typename T>
+Array<T>
+Array<T>::swapaxes(arg_type first, arg_type second) const
+{
+    return Array<T>(full_view().swapaxes(first, second));
+}
+
+template <typename T>
+Array<T>
+Array<T>::moveaxis(arg_type source, arg_type destination) const
+{
+    return Array<T>(full_view().moveaxis(source, destination));
+}
+
 template <typename T>
 Array<T>&
 Array<T>::operator=(const Array &rhv)
@@ -128,6 +204,20 @@ Array<T>::operator=(const Array &rhv)
     if (this != &rhv) {
         n_data = rhv.n_data;
         n_dims = rhv.n_dims;
+        n_strides = rhv.n_strides;
+    }
+    return *this;
+}
+
+template <typename T>
+Array<T>&
+Array<T>::operator=(Array&& rhv) noexcept
+{
+    if (this != &rhv) {
+        n_data = std::move(rhv.n_data);
+        n_dims = rhv.n_dims;
+        n_strides = rhv.n_strides;
+        rhv.reset_empty();
     }
     return *this;
 }
@@ -146,18 +236,15 @@ void Array<T>::pop_back()
 
 template <typename T>
 const T&
-Array<T>::get_value(const std::vector<arg_type>& args) const
+Array<T>::get_value(const Shape& args) const
 {
     if (args.size() > n_dims.size()) {
         throw std::invalid_argument("Arguments are out of dimention!");
     }
 
-    arg_type elem_count = n_data.size();
-
     arg_type index = 0;
-    for (size_t x = 0; x < n_dims.size(); ++x) {
-        elem_count /= n_dims[x];
-        index += args[x] * elem_count;
+    for (size_t x = 0; x < args.size(); ++x) {
+        index += args[x] * n_strides[x];
     }
 
     return n_data[index];
@@ -165,18 +252,15 @@ Array<T>::get_value(const std::vector<arg_type>& args) const
 
 template <typename T>
 T&
-Array<T>::get_value(const std::vector<arg_type>& args)
+Array<T>::get_value(const Shape& args)
 {
     if (args.size() > n_dims.size()) {
         throw std::invalid_argument("Arguments are out of dimention!");
     }
 
-    arg_type elem_count = n_data.size();
-
     arg_type index = 0;
-    for (size_t x = 0; x < n_dims.size(); ++x) {
-        elem_count /= n_dims[x];
-        index += args[x] * elem_count;
+    for (size_t x = 0; x < args.size(); ++x) {
+        index += args[x] * n_strides[x];
     }
 
     return n_data[index];
@@ -278,15 +362,12 @@ Array<T>::clip(arg_type min_val, arg_type max_val) const
 
 template <typename T>
 Array<T> 
-Array<T>::reshape(const std::vector<arg_type>& new_shape)
+Array<T>::reshape(const Shape& new_shape)
 {
-    arg_type sum1 = 1, sum2 = 1;
-    for (auto& i : new_shape) sum1 *= i;
-    for (auto& i : n_dims) sum2 *= i;
-
-    if (sum1 != sum2) throw std::invalid_argument("Invalid shape size."); 
+    if (new_shape.total() != n_dims.total()) throw std::invalid_argument("Invalid shape size."); 
     Array<T> res(*this);
     res.n_dims = new_shape;
+    res.update_strides();
     return res;
 }
 
@@ -310,7 +391,7 @@ template <typename T>
 Array<T> 
 Array<T>::unique_sorted() const
 {
-    std::vector<T> temp = n_data;
+    std::vector<T> temp(n_data.begin(), n_data.end());
     std::sort(temp.begin(), temp.end());
     Array<T> result;
 
@@ -509,6 +590,38 @@ Array<T>::operator/(const Array<T>& rhv) const
     return Array<T>();
 }
 
+template <typename T>
+template <typename U>
+Array<promote_t<T, U>>
+Array<T>::operator+(const Array<U>& rhv) const
+{
+    return calculate_mixed(rhv, Sign::SUM);
+}
+
+template <typename T>
+template <typename U>
+Array<promote_t<T, U>>
+Array<T>::operator-(const Array<U>& rhv) const
+{
+    return calculate_mixed(rhv, Sign::SUBTRACT);
+}
+
+template <typename T>
+template <typename U>
+Array<promote_t<T, U>>
+Array<T>::operator*(const Array<U>& rhv) const
+{
+    return calculate_mixed(rhv, Sign::MULTIPLY);
+}
+
+template <typename T>
+template <typename U>
+Array<promote_t<T, U>>
+Array<T>::operator/(const Array<U>& rhv) const
+{
+    return calculate_mixed(rhv, Sign::DIVIDE);
+}
+
 // Comparison operators
 
 template <typename T>
@@ -679,7 +792,7 @@ Array<T>::operator[](arg_type index) const
 // --- Bool, non-const (returns proxy reference) ---
 template <typename T>
 template <typename U>
-typename std::enable_if<std::is_same<U, bool>::value, typename std::vector<bool>::reference>::type
+typename std::enable_if<std::is_same<U, bool>::value, typename Array<T>::storage_type::reference>::type
 Array<T>::operator[](arg_type index)
 {
     assert((index >= 0 && index < size()) ||
@@ -721,34 +834,55 @@ Array<T>::size() const
 }
 
 template <typename T>
-const std::vector<arg_type> &Array<T>::shape() const
+T*
+Array<T>::data()
+{
+    return n_data.data();
+}
+
+template <typename T>
+const T*
+Array<T>::data() const
+{
+    return n_data.data();
+}
+
+template <typename T>
+const Shape&
+Array<T>::shape() const
 {
     return n_dims;
 }
 
 template <typename T>
-void Array<T>::print_data() const
+const Shape&
+Array<T>::strides() const
 {
-    if (n_data.empty() || n_dims.empty()) {
-        return;
-    }
-    size_t cols = n_dims.back();
-    if (cols == 0) {
-        return;
-    }
-    arg_type column_counter = 0;
+    return n_strides;
+}
 
-    for (size_t i = 0; i < n_data.size(); ++i) {
-        std::cout << n_data[i] << " ";
-        ++column_counter;
-        if (column_counter == arg_type(cols)) {
-            std::cout << std::endl;
-            column_counter = 0;
-        }
-    }
-    if (column_counter != 0) {
-        std::cout << std::endl;
-    }
+template <typename T>
+void
+Array<T>::update_strides()
+{
+    n_strides = n_dims.strides();
+}
+
+template <typename T>
+void
+Array<T>::reset_empty() noexcept
+{
+    n_data.clear();
+    n_dims.clear();
+    n_dims.push_back(0);
+    update_strides();
+}
+
+template <typename T>
+void
+Array<T>::print_data() const
+{
+    Global::detail::print_values(n_data, n_dims);
 }
 
 template <typename T>
@@ -765,8 +899,8 @@ template <typename T>
 typename Array<T>::Broadcast
 Array<T>::can_broadcast(const Array<T>& first, const Array<T>& second)
 {
-    const std::vector<arg_type>& s1 = first.n_dims;
-    const std::vector<arg_type>& s2 = second.n_dims;
+    const Shape& s1 = first.n_dims;
+    const Shape& s2 = second.n_dims;
 
     const size_t n1 = s1.size();
     const size_t n2 = s2.size();
@@ -799,47 +933,40 @@ Array<T>::can_broadcast(const Array<T>& first, const Array<T>& second)
 
 template <typename T>
 Array<T>
-Array<T>::broadcast(const Array<T>& arr, const std::vector<arg_type>& dims)
+Array<T>::broadcast(const Array<T>& arr, const Shape& dims)
 {
     // arr has shape arr.n_dims, we want to broadcast to dims
     assert(dims.size() >= arr.n_dims.size());
 
-    // Check compatibility
-    for (size_t i = 0; i < arr.n_dims.size(); ++i) {
-        arg_type a = arr.n_dims[arr.n_dims.size() - 1 - i];
-        arg_type b = dims[dims.size() - 1 - i];
-        assert(a == b || a == 1); // broadcast rule
+    // Source stride for every target dimension, 0 where arr is repeated
+    const arg_type ndim = dims.size();
+    const arg_type lead = ndim - arr.n_dims.size();
+    Shape src_strides(ndim, 0);
+    for (arg_type j = lead; j < ndim; ++j) {
+        arg_type a = arr.n_dims[j - lead];
+        assert(a == dims[j] || a == 1); // broadcast rule
+        if (a > 1) src_strides[j] = arr.n_strides[j - lead];
     }
 
     Array<T> result;
     result.n_dims = dims;
+    result.update_strides();
 
-    // compute total size
-    arg_type total = 1;
-    for (auto d : dims) total *= d;
+    const arg_type total = dims.total();
     result.n_data.reserve(total);
+    if (total == 0) return result;
 
-    // Flattened repeat
-    std::vector<arg_type> stride(arr.n_dims.size(), 1);
-    for (int i = arr.n_dims.size() - 2; i >= 0; --i) {
-        stride[i] = stride[i + 1] * arr.n_dims[i + 1];
-    }
-
+    // Flattened repeat, walking the source offset with a coordinate counter
+    Shape coords(ndim, 0);
+    arg_type idx = 0;
     for (arg_type i = 0; i < total; ++i) {
-        // map i into arr index
-        arg_type idx = 0;
-        arg_type tmp = i;
-        for (int j = dims.size() - 1, k = arr.n_dims.size() - 1;
-             j >= 0; --j, --k) {
-            arg_type coord = tmp % dims[j];
-            tmp /= dims[j];
-
-            if (k >= 0) {
-                arg_type aj = arr.n_dims[k];
-                if (aj > 1) idx += coord * stride[k];
-            }
-        }
         result.n_data.push_back(arr.n_data[idx]);
+        for (arg_type j = ndim - 1; j >= 0; --j) {
+            idx += src_strides[j];
+            if (++coords[j] < dims[j]) break;
+            idx -= src_strides[j] * dims[j];
+            coords[j] = 0;
+        }
     }
     return result;
 }
@@ -853,6 +980,7 @@ Array<T>::calculate(const Array<T>& first, const Array<T>& second, Sign sign)
 
     Array<T> result(first.size());
     result.n_dims = first.n_dims;
+    result.n_strides = first.n_strides;
     for (arg_type i = 0; i < result.size(); ++i) {
         if (sign == Sign::DIVIDE && second[i] == 0) {
             throw std::runtime_error("Division by zero in Viewer::calculate");
@@ -868,14 +996,106 @@ Array<T>::calculate(const Array<T>& first, const Array<T>& second, Sign sign)
     return result;
 }
 
+template <typename T>
+template <typename U>
+Array<promote_t<T, U>>
+Array<T>::calculate_mixed(const Array<U>& rhv, Sign sign) const
+{
+    using R = promote_t<T, U>;
+
+    // Broadcast shape and the source strides of both operands, 0 along repeated dimensions
+    const Shape& s1 = n_dims;
+    const Shape& s2 = rhv.shape();
+    const arg_type ndim = std::max(s1.size(), s2.size());
+    const arg_type lead1 = ndim - s1.size();
+    const arg_type lead2 = ndim - s2.size();
+    Shape dims(ndim), st1(ndim, 0), st2(ndim, 0);
+    for (arg_type j = 0; j < ndim; ++j) {
+        const arg_type d1 = j < lead1 ? 1 : s1[j - lead1];
+        const arg_type d2 = j < lead2 ? 1 : s2[j - lead2];
+        if (d1 != d2 && d1 != 1 && d2 != 1) return Array<R>();
+        dims[j] = d1 == 1 ? d2 : d1;
+        if (j >= lead1 && d1 > 1) st1[j] = n_strides[j - lead1];
+        if (j >= lead2 && d2 > 1) st2[j] = rhv.strides()[j - lead2];
+    }
+
+    Array<R> result(dims, R());
+    const arg_type total = result.size();
+    if (total == 0) return result;
+
+    const T* a = n_data.data();
+    const U* b = rhv.data();
+    R* out = result.data();
+    const bool same_shape = s1 == s2;
+
+    // Operands are converted element by element as they are read, no promoted copies
+    auto run = [&](auto op) {
+        Parallel::parallel_for(0, total, [&](arg_type begin, arg_type end) {
+            if (same_shape) {
+                for (arg_type i = begin; i < end; ++i) out[i] = op(static_cast<R>(a[i]), static_cast<R>(b[i]));
+                return;
+            }
+            Shape coords(ndim, 0);
+            arg_type ia = 0, ib = 0;
+            for (arg_type j = ndim - 1, rem = begin; j >= 0; --j) {
+                coords[j] = rem % dims[j];
+                rem /= dims[j];
+                ia += coords[j] * st1[j];
+                ib += coords[j] * st2[j];
+            }
+            for (arg_type i = begin; i < end; ++i) {
+                out[i] = op(static_cast<R>(a[ia]), static_cast<R>(b[ib]));
+                for (arg_type j = ndim - 1; j >= 0; --j) {
+                    ia += st1[j];
+                    ib += st2[j];
+                    if (++coords[j] < dims[j]) break;
+                    ia -= st1[j] * dims[j];
+                    ib -= st2[j] * dims[j];
+                    coords[j] = 0;
+                }
+            }
+        });
+    };
+
+    switch (sign)
+    {
+    case Sign::SUM:      run([](R x, R y) -> R { return x + y; }); break;
+    case Sign::SUBTRACT: run([](R x, R y) -> R { return x - y; }); break;
+    case Sign::MULTIPLY: run([](R x, R y) -> R { return x * y; }); break;
+    case Sign::DIVIDE:
+        run([](R x, R y) -> R {
+            if (y == R(0)) throw std::runtime_error("Division by zero in Array::calculate_mixed");
+            return x / y;
+        });
+        break;
+    }
+    return result;
+}
+
 template <typename T>
 template <typename U>
 Array<U>
 Array<T>::cast() const
 {
-    Array<U> result;
-    for (const auto& val : n_data) {
-        result.push_back(static_cast<U>(val));
+    const arg_type total = size();
+    Array<U> result(!n_dims.empty() && n_dims.total() == total ? n_dims : Shape{total}, U());
+    if constexpr (std::is_same_v<U, bool> || std::is_same_v<T, bool>) {
+        // Packed bool storage has no data() and shares words between neighbours
+        std::transform(n_data.begin(), n_data.end(), result.begin(),
+                       [](const T& x) { return static_cast<U>(x); });
+    } else {
+        const T* src = n_data.data();
+        U* dst = result.data();
+
+        Parallel::parallel_for(0, total, [&](arg_type b, arg_type e) {
+            if constexpr (detail::is_half_v<T> && std::is_same_v<U, float>) {
+                detail::widen(src + b, dst + b, e - b);
+            } else if constexpr (std::is_same_v<T, float> && detail::is_half_v<U>) {
+                detail::narrow(src + b, dst + b, e - b);
+            } else {
+                for (arg_type i = b; i < e; ++i) dst[i] = static_cast<U>(src[i]);
+            }
+        });
     }
     return result;
 }
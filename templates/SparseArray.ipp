@@ -0,0 +1,618 @@
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <limits>
+
+namespace SamH::NumC
+{
+
+namespace detail
+{
+    // Rows (or columns) per parallel chunk so that each chunk holds about `grain` non-zeros
+    inline arg_type sparse_grain(arg_type segments, arg_type nnz)
+    {
+        if (nnz <= 0) return std::max<arg_type>(1, segments);
+        return std::max<arg_type>(64, Parallel::DEFAULT_GRAIN * segments / nnz);
+    }
+
+    // Shape of a dense operand viewed as a matrix, 1-D arrays become a single row
+    inline void dense_matrix_shape(const Shape& shape, arg_type& rows, arg_type& cols)
+    {
+        if (shape.size() == 1)      { rows = 1;        cols = shape[0]; }
+        else if (shape.size() == 2) { rows = shape[0]; cols = shape[1]; }
+        else throw std::invalid_argument("SparseArray::Only 1-D and 2-D arrays are supported");
+    }
+}
+
+template <typename T>
+SparseArray<T>::SparseArray(arg_type rows, arg_type cols, Format format)
+    : s_format(format)
+    , s_rows(rows)
+    , s_cols(cols)
+{
+    if (rows < 0 || cols < 0) throw std::invalid_argument("SparseArray::Invalid shape");
+    if (format == CSR) s_indptr.assign(rows + 1, 0);
+    if (format == CSC) s_indptr.assign(cols + 1, 0);
+}
+
+template <typename T>
+SparseArray<T>::SparseArray(const Array<T>& dense, Format format)
+    : SparseArray(dense, dense != T(0), format)
+{}
+
+template <typename T>
+SparseArray<T>::SparseArray(const Array<T>& dense, const Mask& selection, Format format)
+    : s_format(CSR)
+{
+    if (dense.size() != selection.size()) {
+        throw std::invalid_argument("SparseArray::Mask size does not match the array");
+    }
+    detail::dense_matrix_shape(dense.shape(), s_rows, s_cols);
+
+    // Two passes over the rows: count the selected entries, then fill at the prefix offsets
+    const T* src = dense.data();
+    s_indptr.assign(s_rows + 1, 0);
+    Parallel::parallel_for(0, s_rows, [&](arg_type b, arg_type e) {
+        for (arg_type r = b; r < e; ++r) {
+            arg_type count = 0;
+            for (arg_type c = 0; c < s_cols; ++c) count += selection[r * s_cols + c];
+            s_indptr[r + 1] = count;
+        }
+    }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / std::max<arg_type>(1, s_cols)));
+    std::partial_sum(s_indptr.begin(), s_indptr.end(), s_indptr.begin());
+
+    s_indices.resize(s_indptr.back());
+    s_values.resize(s_indptr.back());
+    Parallel::parallel_for(0, s_rows, [&](arg_type b, arg_type e) {
+        for (arg_type r = b; r < e; ++r) {
+            arg_type pos = s_indptr[r];
+            for (arg_type c = 0; c < s_cols; ++c) {
+                if (selection[r * s_cols + c]) {
+                    s_indices[pos] = c;
+                    s_values[pos++] = src[r * s_cols + c];
+                }
+            }
+        }
+    }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / std::max<arg_type>(1, s_cols)));
+
+    if (format != CSR) *this = asformat(format);
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::from_triplets(arg_type rows, arg_type cols,
+                              const Array<arg_type>& row_idx,
+                              const Array<arg_type>& col_idx,
+                              const Array<T>& values,
+                              Format format)
+{
+    if (row_idx.size() != col_idx.size() || row_idx.size() != values.size()) {
+        throw std::invalid_argument("SparseArray::Triplet arrays must have the same size");
+    }
+    for (arg_type i = 0; i < row_idx.size(); ++i) {
+        if (row_idx[i] < 0 || row_idx[i] >= rows || col_idx[i] < 0 || col_idx[i] >= cols) {
+            throw std::out_of_range("SparseArray::Triplet index out of range");
+        }
+    }
+    return from_coo(rows, cols,
+                    std::vector<arg_type>(row_idx.begin(), row_idx.end()),
+                    std::vector<arg_type>(col_idx.begin(), col_idx.end()),
+                    std::vector<T>(values.begin(), values.end()),
+                    format);
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::from_coo(arg_type rows, arg_type cols,
+                         std::vector<arg_type> row_idx,
+                         std::vector<arg_type> col_idx,
+                         std::vector<T> values,
+                         Format format)
+{
+    SparseArray res(rows, cols, format);
+    if (format == COO) {
+        res.s_coo_rows = std::move(row_idx);
+        res.s_indices  = std::move(col_idx);
+        res.s_values   = std::move(values);
+        return res;
+    }
+
+    const std::vector<arg_type>& major = (format == CSR) ? row_idx : col_idx;
+    const std::vector<arg_type>& minor = (format == CSR) ? col_idx : row_idx;
+    const arg_type n_major = (format == CSR) ? rows : cols;
+    const arg_type nnz = values.size();
+
+    // Counting sort by the major index
+    std::vector<arg_type> ptr(n_major + 1, 0);
+    for (arg_type i = 0; i < nnz; ++i) ++ptr[major[i] + 1];
+    std::partial_sum(ptr.begin(), ptr.end(), ptr.begin());
+
+    std::vector<arg_type> fill(ptr.begin(), ptr.end() - 1);
+    std::vector<arg_type> tmp_minor(nnz);
+    std::vector<T> tmp_values(nnz);
+    for (arg_type i = 0; i < nnz; ++i) {
+        const arg_type pos = fill[major[i]]++;
+        tmp_minor[pos] = minor[i];
+        tmp_values[pos] = values[i];
+    }
+
+    // Sort every segment by the minor index and sum duplicates
+    res.s_indices.reserve(nnz);
+    res.s_values.reserve(nnz);
+    std::vector<arg_type> order;
+    for (arg_type m = 0; m < n_major; ++m) {
+        const arg_type b = ptr[m], e = ptr[m + 1];
+        order.resize(e - b);
+        std::iota(order.begin(), order.end(), b);
+        std::sort(order.begin(), order.end(),
+                  [&](arg_type x, arg_type y) { return tmp_minor[x] < tmp_minor[y]; });
+
+        const arg_type seg_begin = res.s_indices.size();
+        for (arg_type k : order) {
+            if (static_cast<arg_type>(res.s_indices.size()) > seg_begin && res.s_indices.back() == tmp_minor[k]) {
+                res.s_values.back() += tmp_values[k];
+            } else {
+                res.s_indices.push_back(tmp_minor[k]);
+                res.s_values.push_back(tmp_values[k]);
+            }
+        }
+        res.s_indptr[m + 1] = res.s_indices.size();
+    }
+    return res;
+}
+
+// Conversions
+
+template <typename T>
+typename SparseArray<T>::Format
+SparseArray<T>::format() const
+{
+    return s_format;
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::compressed(Format format) const
+{
+    if (s_format == format) return *this;
+    if (s_format == COO) return from_coo(s_rows, s_cols, s_coo_rows, s_indices, s_values, format);
+
+    // CSR <-> CSC: counting pass over the minor index; segments are visited in
+    // order, so the new minor indices come out sorted without another sort
+    const arg_type n_major = (s_format == CSR) ? s_rows : s_cols;
+    const arg_type n_minor = (s_format == CSR) ? s_cols : s_rows;
+
+    SparseArray res(s_rows, s_cols, format);
+    for (arg_type idx : s_indices) ++res.s_indptr[idx + 1];
+    std::partial_sum(res.s_indptr.begin(), res.s_indptr.end(), res.s_indptr.begin());
+
+    res.s_indices.resize(nnz());
+    res.s_values.resize(nnz());
+    std::vector<arg_type> fill(res.s_indptr.begin(), res.s_indptr.begin() + n_minor);
+    for (arg_type m = 0; m < n_major; ++m) {
+        for (arg_type k = s_indptr[m]; k < s_indptr[m + 1]; ++k) {
+            const arg_type pos = fill[s_indices[k]]++;
+            res.s_indices[pos] = m;
+            res.s_values[pos] = s_values[k];
+        }
+    }
+    return res;
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::asformat(Format format) const
+{
+    if (format != COO) return compressed(format);
+    if (s_format == COO) return *this;
+
+    SparseArray res(s_rows, s_cols, COO);
+    const arg_type n_major = (s_format == CSR) ? s_rows : s_cols;
+    std::vector<arg_type> major(nnz());
+    for (arg_type m = 0; m < n_major; ++m) {
+        std::fill(major.begin() + s_indptr[m], major.begin() + s_indptr[m + 1], m);
+    }
+    res.s_values = s_values;
+    if (s_format == CSR) {
+        res.s_coo_rows = std::move(major);
+        res.s_indices  = s_indices;
+    } else {
+        res.s_coo_rows = s_indices;
+        res.s_indices  = std::move(major);
+    }
+    return res;
+}
+
+template <typename T>
+Array<T>
+SparseArray<T>::to_dense() const
+{
+    Array<T> res(Shape{s_rows, s_cols}, T(0));
+    T* out = res.data();
+    if (s_format == COO) {
+        for (arg_type k = 0; k < nnz(); ++k) out[s_coo_rows[k] * s_cols + s_indices[k]] += s_values[k];
+        return res;
+    }
+
+    const bool row_major = (s_format == CSR);
+    const arg_type n_major = row_major ? s_rows : s_cols;
+    for (arg_type m = 0; m < n_major; ++m) {
+        for (arg_type k = s_indptr[m]; k < s_indptr[m + 1]; ++k) {
+            const arg_type r = row_major ? m : s_indices[k];
+            const arg_type c = row_major ? s_indices[k] : m;
+            out[r * s_cols + c] = s_values[k];
+        }
+    }
+    return res;
+}
+
+// Properties
+
+template <typename T>
+arg_type
+SparseArray<T>::rows() const
+{
+    return s_rows;
+}
+
+template <typename T>
+arg_type
+SparseArray<T>::cols() const
+{
+    return s_cols;
+}
+
+template <typename T>
+arg_type
+SparseArray<T>::nnz() const
+{
+    return s_values.size();
+}
+
+template <typename T>
+Shape
+SparseArray<T>::shape() const
+{
+    return Shape{s_rows, s_cols};
+}
+
+template <typename T>
+double
+SparseArray<T>::density() const
+{
+    const double total = static_cast<double>(s_rows) * static_cast<double>(s_cols);
+    return total > 0 ? nnz() / total : 0.0;
+}
+
+template <typename T>
+T
+SparseArray<T>::get_value(arg_type row, arg_type col) const
+{
+    if (row < 0 || row >= s_rows || col < 0 || col >= s_cols) {
+        throw std::out_of_range("SparseArray::Index out of range");
+    }
+    if (s_format == COO) {
+        T res = T(0);
+        for (arg_type k = 0; k < nnz(); ++k) {
+            if (s_coo_rows[k] == row && s_indices[k] == col) res += s_values[k];
+        }
+        return res;
+    }
+
+    const arg_type major = (s_format == CSR) ? row : col;
+    const arg_type minor = (s_format == CSR) ? col : row;
+    const auto first = s_indices.begin() + s_indptr[major];
+    const auto last  = s_indices.begin() + s_indptr[major + 1];
+    const auto it = std::lower_bound(first, last, minor);
+    return (it != last && *it == minor) ? s_values[it - s_indices.begin()] : T(0);
+}
+
+// Products
+
+template <typename T>
+Array<T>
+SparseArray<T>::dot(const Array<T>& rhv) const
+{
+    if (s_format == COO) return compressed(CSR).dot(rhv);
+
+    const Shape& rshape = rhv.shape();
+    if (rshape.empty() || rshape.size() > 2 || rshape[0] != s_cols) {
+        throw std::invalid_argument("SparseArray::dot shape mismatch");
+    }
+    const arg_type n = (rshape.size() == 2) ? rshape[1] : 1;
+    Array<T> res = (rshape.size() == 2) ? Array<T>(Shape{s_rows, n}, T(0)) : Array<T>(Shape{s_rows}, T(0));
+    const T* x = rhv.data();
+    T* y = res.data();
+
+    if (s_format == CSR) {
+        // Rows are independent: each thread writes its own slice of the output
+        Parallel::parallel_for(0, s_rows, [&](arg_type b, arg_type e) {
+            for (arg_type r = b; r < e; ++r) {
+                T* out = y + r * n;
+                for (arg_type k = s_indptr[r]; k < s_indptr[r + 1]; ++k) {
+                    const T v = s_values[k];
+                    const T* in = x + s_indices[k] * n;
+                    for (arg_type j = 0; j < n; ++j) out[j] += v * in[j];
+                }
+            }
+        }, detail::sparse_grain(s_rows, nnz() * n));
+        return res;
+    }
+
+    // CSC scatters into the output: every chunk of columns accumulates into a private buffer
+    const arg_type out_size = s_rows * n;
+    const arg_type chunks = Parallel::chunk_count(nnz() * n);
+    if (chunks <= 1) {
+        for (arg_type c = 0; c < s_cols; ++c) {
+            for (arg_type k = s_indptr[c]; k < s_indptr[c + 1]; ++k) {
+                const T v = s_values[k];
+                T* out = y + s_indices[k] * n;
+                for (arg_type j = 0; j < n; ++j) out[j] += v * x[c * n + j];
+            }
+        }
+        return res;
+    }
+
+    std::vector<std::vector<T>> partial(chunks);
+    Parallel::parallel_chunks(0, s_cols, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+        std::vector<T>& acc = partial[chunk];
+        acc.assign(out_size, T(0));
+        for (arg_type c = b; c < e; ++c) {
+            for (arg_type k = s_indptr[c]; k < s_indptr[c + 1]; ++k) {
+                const T v = s_values[k];
+                T* out = acc.data() + s_indices[k] * n;
+                for (arg_type j = 0; j < n; ++j) out[j] += v * x[c * n + j];
+            }
+        }
+    });
+    Parallel::parallel_for(0, out_size, [&](arg_type b, arg_type e) {
+        for (const auto& acc : partial) {
+            if (acc.empty()) continue;
+            for (arg_type i = b; i < e; ++i) y[i] += acc[i];
+        }
+    });
+    return res;
+}
+
+// Elementwise operations
+
+template <typename T>
+template <typename Op>
+SparseArray<T>
+SparseArray<T>::merge(const SparseArray& rhv, Op op, bool keep_union) const
+{
+    if (s_rows != rhv.s_rows || s_cols != rhv.s_cols) {
+        throw std::invalid_argument("SparseArray::Shapes do not match");
+    }
+    const SparseArray a = compressed(CSR);
+    const SparseArray b = rhv.compressed(CSR);
+
+    // Walks two sorted rows together and calls emit(col, value) for each result entry
+    auto merge_row = [&](arg_type r, auto&& emit) {
+        arg_type i = a.s_indptr[r], ie = a.s_indptr[r + 1];
+        arg_type j = b.s_indptr[r], je = b.s_indptr[r + 1];
+        while (i < ie || j < je) {
+            const arg_type ca = (i < ie) ? a.s_indices[i] : s_cols;
+            const arg_type cb = (j < je) ? b.s_indices[j] : s_cols;
+            if (ca == cb) {
+                emit(ca, op(a.s_values[i++], b.s_values[j++]));
+            } else if (ca < cb) {
+                if (keep_union) emit(ca, op(a.s_values[i], T(0)));
+                ++i;
+            } else {
+                if (keep_union) emit(cb, op(T(0), b.s_values[j]));
+                ++j;
+            }
+        }
+    };
+
+    SparseArray res(s_rows, s_cols, CSR);
+    const arg_type grain = detail::sparse_grain(s_rows, a.nnz() + b.nnz());
+    Parallel::parallel_for(0, s_rows, [&](arg_type rb, arg_type re) {
+        for (arg_type r = rb; r < re; ++r) {
+            arg_type count = 0;
+            merge_row(r, [&](arg_type, const T&) { ++count; });
+            res.s_indptr[r + 1] = count;
+        }
+    }, grain);
+    std::partial_sum(res.s_indptr.begin(), res.s_indptr.end(), res.s_indptr.begin());
+
+    res.s_indices.resize(res.s_indptr.back());
+    res.s_values.resize(res.s_indptr.back());
+    Parallel::parallel_for(0, s_rows, [&](arg_type rb, arg_type re) {
+        for (arg_type r = rb; r < re; ++r) {
+            arg_type pos = res.s_indptr[r];
+            merge_row(r, [&](arg_type c, const T& v) {
+                res.s_indices[pos] = c;
+                res.s_values[pos++] = v;
+            });
+        }
+    }, grain);
+
+    return (s_format == CSR) ? res : res.asformat(s_format);
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::operator+(const SparseArray& rhv) const
+{
+    return merge(rhv, [](const T& x, const T& y) { return x + y; }, true);
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::operator-(const SparseArray& rhv) const
+{
+    return merge(rhv, [](const T& x, const T& y) { return x - y; }, true);
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::operator*(const SparseArray& rhv) const
+{
+    return merge(rhv, [](const T& x, const T& y) { return x * y; }, false);
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::operator*(const Array<T>& rhv) const
+{
+    arg_type rows, cols;
+    detail::dense_matrix_shape(rhv.shape(), rows, cols);
+    if (rows != s_rows || cols != s_cols) {
+        throw std::invalid_argument("SparseArray::Shapes do not match");
+    }
+
+    // Only stored entries can be non-zero in the product, so the pattern is kept as is
+    SparseArray res = compressed(s_format == COO ? COO : CSR);
+    const T* dense = rhv.data();
+    const arg_type n_major = (res.s_format == COO) ? 0 : s_rows;
+    if (res.s_format == COO) {
+        for (arg_type k = 0; k < res.nnz(); ++k) {
+            res.s_values[k] *= dense[res.s_coo_rows[k] * s_cols + res.s_indices[k]];
+        }
+    } else {
+        Parallel::parallel_for(0, n_major, [&](arg_type b, arg_type e) {
+            for (arg_type r = b; r < e; ++r) {
+                for (arg_type k = res.s_indptr[r]; k < res.s_indptr[r + 1]; ++k) {
+                    res.s_values[k] *= dense[r * s_cols + res.s_indices[k]];
+                }
+            }
+        }, detail::sparse_grain(s_rows, res.nnz()));
+    }
+    return (res.s_format == s_format) ? res : res.asformat(s_format);
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::operator*(const T& rhv) const
+{
+    SparseArray res(*this);
+    Parallel::parallel_for(0, res.nnz(), [&](arg_type b, arg_type e) {
+        for (arg_type k = b; k < e; ++k) res.s_values[k] *= rhv;
+    });
+    return res;
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::operator/(const T& rhv) const
+{
+    if (rhv == T(0)) {
+        throw std::runtime_error("Division by zero in SparseArray::operator/");
+    }
+    SparseArray res(*this);
+    Parallel::parallel_for(0, res.nnz(), [&](arg_type b, arg_type e) {
+        for (arg_type k = b; k < e; ++k) res.s_values[k] /= rhv;
+    });
+    return res;
+}
+
+template <typename T>
+SparseArray<T>
+SparseArray<T>::transpose() const
+{
+    // CSR of A holds exactly the CSC of A^T, so no data moves
+    SparseArray res(*this);
+    std::swap(res.s_rows, res.s_cols);
+    if (s_format == CSR) res.s_format = CSC;
+    else if (s_format == CSC) res.s_format = CSR;
+    else std::swap(res.s_coo_rows, res.s_indices);
+    return res;
+}
+
+// Reductions
+
+template <typename T>
+T
+SparseArray<T>::sum() const
+{
+    const arg_type chunks = Parallel::chunk_count(nnz());
+    std::vector<T> partial(std::max<arg_type>(1, chunks), T(0));
+    Parallel::parallel_chunks(0, nnz(), chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+        T acc = T(0);
+        for (arg_type k = b; k < e; ++k) acc += s_values[k];
+        partial[chunk] = acc;
+    });
+    T res = T(0);
+    for (const auto& p : partial) res += p;
+    return res;
+}
+
+template <typename T>
+template <typename Op>
+Array<T>
+SparseArray<T>::reduce(arg_type axis, Op op, T init, bool with_zeros) const
+{
+    if (axis < 0) axis += 2;
+    if (axis != 0 && axis != 1) throw std::out_of_range("SparseArray::Axis out of range");
+
+    // Reducing along axis 1 walks rows (CSR segments), along axis 0 columns (CSC segments)
+    const Format needed = (axis == 1) ? CSR : CSC;
+    const SparseArray src = compressed(needed);
+    const arg_type segments = (axis == 1) ? s_rows : s_cols;
+    const arg_type length   = (axis == 1) ? s_cols : s_rows;
+
+    Array<T> res(Shape{segments}, init);
+    T* out = res.data();
+    Parallel::parallel_for(0, segments, [&](arg_type b, arg_type e) {
+        for (arg_type m = b; m < e; ++m) {
+            T acc = init;
+            for (arg_type k = src.s_indptr[m]; k < src.s_indptr[m + 1]; ++k) acc = op(acc, src.s_values[k]);
+            if (with_zeros && src.s_indptr[m + 1] - src.s_indptr[m] < length) acc = op(acc, T(0));
+            out[m] = acc;
+        }
+    }, detail::sparse_grain(segments, nnz()));
+    return res;
+}
+
+template <typename T>
+Array<T>
+SparseArray<T>::sum(arg_type axis) const
+{
+    return reduce(axis, [](const T& acc, const T& v) { return acc + v; }, T(0), false);
+}
+
+template <typename T>
+Array<T>
+SparseArray<T>::mean(arg_type axis) const
+{
+    Array<T> res = sum(axis);
+    const T length = static_cast<T>((axis == 1 || axis == -1) ? s_cols : s_rows);
+    for (arg_type i = 0; i < res.size(); ++i) res[i] = res[i] / length;
+    return res;
+}
+
+template <typename T>
+Array<T>
+SparseArray<T>::min(arg_type axis) const
+{
+    if (s_rows == 0 || s_cols == 0) throw std::invalid_argument("SparseArray::min of an empty array");
+    return reduce(axis, [](const T& acc, const T& v) { return v < acc ? v : acc; },
+                  std::numeric_limits<T>::max(), true);
+}
+
+template <typename T>
+Array<T>
+SparseArray<T>::max(arg_type axis) const
+{
+    if (s_rows == 0 || s_cols == 0) throw std::invalid_argument("SparseArray::max of an empty array");
+    return reduce(axis, [](const T& acc, const T& v) { return v > acc ? v : acc; },
+                  std::numeric_limits<T>::lowest(), true);
+}
+
+template <typename T>
+void
+SparseArray<T>::print_data() const
+{
+    const SparseArray csr = compressed(CSR);
+    for (arg_type r = 0; r < s_rows; ++r) {
+        for (arg_type k = csr.s_indptr[r]; k < csr.s_indptr[r + 1]; ++k) {
+            std::cout << '(' << r << ", " << csr.s_indices[k] << ") " << csr.s_values[k] << '\n';
+        }
+    }
+    std::cout << std::flush;
+}
+
+}
@@ -0,0 +1,443 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace SamH::NumC
+{
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>::StaticArray(const T& fill)
+{
+    for_each_index([&](arg_type i) { n_data[i] = fill; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>::StaticArray(const std::initializer_list<T>& init)
+    : n_data{}
+{
+    if (static_cast<arg_type>(init.size()) != total) {
+        throw std::invalid_argument("StaticArray::Initializer size does not match the shape");
+    }
+    std::copy(init.begin(), init.end(), n_data.begin());
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>::StaticArray(const Array<T>& arr)
+    : n_data{}
+{
+    const auto& shape = arr.shape();
+    if (static_cast<arg_type>(shape.size()) != ndim) {
+        throw std::invalid_argument("StaticArray::Dimension count mismatch");
+    }
+    for (arg_type i = 0; i < ndim; ++i) {
+        if (shape[i] != dims[i]) throw std::invalid_argument("StaticArray::Shape mismatch");
+    }
+    std::copy(arr.begin(), arr.end(), n_data.begin());
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>::operator Array<T>() const
+{
+    return to_array();
+}
+
+template <typename T, arg_type... Dims>
+Array<T>
+StaticArray<T, Dims...>::to_array() const
+{
+    Array<T> res(Shape(dims.begin(), dims.end()), T());
+    std::copy(n_data.begin(), n_data.end(), res.begin());
+    return res;
+}
+
+// Access operators
+
+template <typename T, arg_type... Dims>
+template <typename... Idx>
+T&
+StaticArray<T, Dims...>::operator()(Idx... idx)
+{
+    static_assert(sizeof...(Idx) == ndim, "Incorrect number of coordinates provided.");
+    arg_type offset = 0, d = 0;
+    ((offset += static_cast<arg_type>(idx) * strides[d++]), ...);
+    assert(offset >= 0 && offset < total);
+    return n_data[offset];
+}
+
+template <typename T, arg_type... Dims>
+template <typename... Idx>
+const T&
+StaticArray<T, Dims...>::operator()(Idx... idx) const
+{
+    static_assert(sizeof...(Idx) == ndim, "Incorrect number of coordinates provided.");
+    arg_type offset = 0, d = 0;
+    ((offset += static_cast<arg_type>(idx) * strides[d++]), ...);
+    assert(offset >= 0 && offset < total);
+    return n_data[offset];
+}
+
+template <typename T, arg_type... Dims>
+T&
+StaticArray<T, Dims...>::operator[](arg_type index)
+{
+    assert((index >= 0 && index < total) || (index < 0 && -index <= total));
+    return n_data[index >= 0 ? index : index + total];
+}
+
+template <typename T, arg_type... Dims>
+const T&
+StaticArray<T, Dims...>::operator[](arg_type index) const
+{
+    assert((index >= 0 && index < total) || (index < 0 && -index <= total));
+    return n_data[index >= 0 ? index : index + total];
+}
+
+// Elementwise operators
+
+template <typename T, arg_type... Dims>
+template <typename F>
+void
+StaticArray<T, Dims...>::for_each_index(F&& f)
+{
+    if constexpr (total <= detail::STATIC_UNROLL_LIMIT) {
+        detail::static_unroll([&](std::size_t i) { f(static_cast<arg_type>(i)); },
+                              std::make_index_sequence<total>{});
+    } else {
+        for (arg_type i = 0; i < total; ++i) f(i);
+    }
+}
+
+template <typename T, arg_type... Dims>
+template <typename Op>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::apply(const StaticArray& rhv, Op op) const
+{
+    StaticArray res;
+    for_each_index([&](arg_type i) { res.n_data[i] = op(n_data[i], rhv.n_data[i]); });
+    return res;
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator+(const StaticArray& rhv) const
+{
+    return apply(rhv, [](const T& a, const T& b) { return a + b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator-(const StaticArray& rhv) const
+{
+    return apply(rhv, [](const T& a, const T& b) { return a - b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator*(const StaticArray& rhv) const
+{
+    return apply(rhv, [](const T& a, const T& b) { return a * b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator/(const StaticArray& rhv) const
+{
+    return apply(rhv, [](const T& a, const T& b) { return a / b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator+(const T& rhv) const
+{
+    return apply(StaticArray(rhv), [](const T& a, const T& b) { return a + b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator-(const T& rhv) const
+{
+    return apply(StaticArray(rhv), [](const T& a, const T& b) { return a - b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator*(const T& rhv) const
+{
+    return apply(StaticArray(rhv), [](const T& a, const T& b) { return a * b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::operator/(const T& rhv) const
+{
+    return apply(StaticArray(rhv), [](const T& a, const T& b) { return a / b; });
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>&
+StaticArray<T, Dims...>::operator+=(const StaticArray& rhv)
+{
+    for_each_index([&](arg_type i) { n_data[i] += rhv.n_data[i]; });
+    return *this;
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>&
+StaticArray<T, Dims...>::operator-=(const StaticArray& rhv)
+{
+    for_each_index([&](arg_type i) { n_data[i] -= rhv.n_data[i]; });
+    return *this;
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>&
+StaticArray<T, Dims...>::operator*=(const StaticArray& rhv)
+{
+    for_each_index([&](arg_type i) { n_data[i] *= rhv.n_data[i]; });
+    return *this;
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>&
+StaticArray<T, Dims...>::operator/=(const StaticArray& rhv)
+{
+    for_each_index([&](arg_type i) { n_data[i] /= rhv.n_data[i]; });
+    return *this;
+}
+
+template <typename T, arg_type... Dims>
+bool
+StaticArray<T, Dims...>::operator==(const StaticArray& rhv) const
+{
+    return n_data == rhv.n_data;
+}
+
+template <typename T, arg_type... Dims>
+bool
+StaticArray<T, Dims...>::operator!=(const StaticArray& rhv) const
+{
+    return n_data != rhv.n_data;
+}
+
+// Linear algebra
+
+template <typename T, arg_type... Dims>
+template <arg_type... RDims>
+auto
+StaticArray<T, Dims...>::dot(const StaticArray<T, RDims...>& rhv) const
+{
+    constexpr std::array<arg_type, sizeof...(RDims)> rdims = { RDims... };
+    constexpr arg_type inner = dims[ndim - 1];
+    static_assert(ndim <= 2 && sizeof...(RDims) <= 2, "dot supports only 1-D and 2-D operands");
+    static_assert(inner == rdims[0], "dot::Inner dimensions do not match");
+
+    if constexpr (ndim == 1 && sizeof...(RDims) == 1) {
+        T res = T();
+        for_each_index([&](arg_type i) { res += n_data[i] * rhv[i]; });
+        return res;
+    } else if constexpr (ndim == 2 && sizeof...(RDims) == 1) {
+        StaticArray<T, dims[0]> res;
+        for (arg_type i = 0; i < dims[0]; ++i) {
+            T acc = T();
+            for (arg_type k = 0; k < inner; ++k) acc += n_data[i * inner + k] * rhv[k];
+            res[i] = acc;
+        }
+        return res;
+    } else if constexpr (ndim == 1 && sizeof...(RDims) == 2) {
+        constexpr arg_type cols = rdims[1];
+        StaticArray<T, cols> res;
+        for (arg_type k = 0; k < inner; ++k)
+            for (arg_type j = 0; j < cols; ++j) res[j] += n_data[k] * rhv[k * cols + j];
+        return res;
+    } else {
+        constexpr arg_type rows = dims[0];
+        constexpr arg_type cols = rdims[1];
+        StaticArray<T, rows, cols> res;
+        StaticArray<T, rows, cols>::for_each_index([&](arg_type idx) {
+            const arg_type i = idx / cols, j = idx % cols;
+            T acc = T();
+            for (arg_type k = 0; k < inner; ++k) acc += n_data[i * inner + k] * rhv[k * cols + j];
+            res[idx] = acc;
+        });
+        return res;
+    }
+}
+
+template <typename T, arg_type... Dims>
+T
+StaticArray<T, Dims...>::det() const
+{
+    static_assert(is_square, "Determinant requires a square matrix");
+    constexpr arg_type n = dims[0];
+    const auto& m = n_data;
+
+    if constexpr (n == 1) {
+        return m[0];
+    } else if constexpr (n == 2) {
+        return m[0] * m[3] - m[1] * m[2];
+    } else if constexpr (n == 3) {
+        return m[0] * (m[4] * m[8] - m[5] * m[7])
+             - m[1] * (m[3] * m[8] - m[5] * m[6])
+             + m[2] * (m[3] * m[7] - m[4] * m[6]);
+    } else {
+        std::array<double, total> mat;
+        for_each_index([&](arg_type i) { mat[i] = static_cast<double>(m[i]); });
+
+        double det = 1.0;
+        for (arg_type i = 0; i < n; ++i) {
+            arg_type pivot = i;
+            for (arg_type j = i + 1; j < n; ++j)
+                if (std::fabs(mat[j * n + i]) > std::fabs(mat[pivot * n + i])) pivot = j;
+
+            // Partial pivoting leaves a zero only when the whole column below is zero;
+            // near-singular integer matrices are settled by the rounding below
+            if (mat[pivot * n + i] == 0.0) return static_cast<T>(0);
+
+            if (pivot != i) {
+                for (arg_type k = 0; k < n; ++k) std::swap(mat[i * n + k], mat[pivot * n + k]);
+                det = -det;
+            }
+
+            det *= mat[i * n + i];
+            for (arg_type j = i + 1; j < n; ++j) {
+                const double factor = mat[j * n + i] / mat[i * n + i];
+                for (arg_type k = i; k < n; ++k) mat[j * n + k] -= factor * mat[i * n + k];
+            }
+        }
+        if constexpr (std::is_integral_v<T>) return static_cast<T>(std::llround(det));
+        else return static_cast<T>(det);
+    }
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::inverse() const
+{
+    static_assert(is_square, "Inverse requires a square matrix");
+    constexpr arg_type n = dims[0];
+    const auto& m = n_data;
+    StaticArray res;
+
+    // Singular means zero up to rounding relative to the matrix's largest entry, so
+    // well-conditioned matrices of any magnitude invert
+    double scale = 0.0;
+    for_each_index([&](arg_type i) { scale = std::max(scale, std::fabs(static_cast<double>(m[i]))); });
+    const double tolerance = n * std::numeric_limits<double>::epsilon() * scale;
+
+    if constexpr (n <= 3) {
+        const double d = static_cast<double>(det());
+        // The determinant scales as the n-th power of the entries
+        if (!(std::fabs(d) > tolerance * std::pow(scale, n - 1))) throw std::runtime_error("Inverse::Matrix is singular");
+        const double inv = 1.0 / d;
+
+        if constexpr (n == 1) {
+            res[0] = static_cast<T>(inv);
+        } else if constexpr (n == 2) {
+            res[0] = static_cast<T>( m[3] * inv);
+            res[1] = static_cast<T>(-m[1] * inv);
+            res[2] = static_cast<T>(-m[2] * inv);
+            res[3] = static_cast<T>( m[0] * inv);
+        } else {
+            res[0] = static_cast<T>((m[4] * m[8] - m[5] * m[7]) * inv);
+            res[1] = static_cast<T>((m[2] * m[7] - m[1] * m[8]) * inv);
+            res[2] = static_cast<T>((m[1] * m[5] - m[2] * m[4]) * inv);
+            res[3] = static_cast<T>((m[5] * m[6] - m[3] * m[8]) * inv);
+            res[4] = static_cast<T>((m[0] * m[8] - m[2] * m[6]) * inv);
+            res[5] = static_cast<T>((m[2] * m[3] - m[0] * m[5]) * inv);
+            res[6] = static_cast<T>((m[3] * m[7] - m[4] * m[6]) * inv);
+            res[7] = static_cast<T>((m[1] * m[6] - m[0] * m[7]) * inv);
+            res[8] = static_cast<T>((m[0] * m[4] - m[1] * m[3]) * inv);
+        }
+        return res;
+    } else {
+        // Gauss-Jordan elimination with partial pivoting
+        std::array<double, total> a, b{};
+        for_each_index([&](arg_type i) { a[i] = static_cast<double>(m[i]); });
+        for (arg_type i = 0; i < n; ++i) b[i * n + i] = 1.0;
+
+        for (arg_type i = 0; i < n; ++i) {
+            arg_type pivot = i;
+            for (arg_type j = i + 1; j < n; ++j)
+                if (std::fabs(a[j * n + i]) > std::fabs(a[pivot * n + i])) pivot = j;
+
+            if (!(std::fabs(a[pivot * n + i]) > tolerance)) throw std::runtime_error("Inverse::Matrix is singular");
+
+            if (pivot != i) {
+                for (arg_type k = 0; k < n; ++k) {
+                    std::swap(a[i * n + k], a[pivot * n + k]);
+                    std::swap(b[i * n + k], b[pivot * n + k]);
+                }
+            }
+
+            const double inv = 1.0 / a[i * n + i];
+            for (arg_type k = 0; k < n; ++k) {
+                a[i * n + k] *= inv;
+                b[i * n + k] *= inv;
+            }
+
+            for (arg_type j = 0; j < n; ++j) {
+                if (j == i) continue;
+                const double factor = a[j * n + i];
+                for (arg_type k = 0; k < n; ++k) {
+                    a[j * n + k] -= factor * a[i * n + k];
+                    b[j * n + k] -= factor * b[i * n + k];
+                }
+            }
+        }
+
+        for_each_index([&](arg_type i) { res[i] = static_cast<T>(b[i]); });
+        return res;
+    }
+}
+
+template <typename T, arg_type... Dims>
+StaticArray<T, Dims...>
+StaticArray<T, Dims...>::transpose() const
+{
+    static_assert(is_square, "transpose requires a square matrix");
+    constexpr arg_type n = dims[0];
+    StaticArray res;
+    for_each_index([&](arg_type idx) { res[(idx % n) * n + idx / n] = n_data[idx]; });
+    return res;
+}
+
+// Reductions
+
+template <typename T, arg_type... Dims>
+T
+StaticArray<T, Dims...>::sum() const
+{
+    T res = T();
+    for_each_index([&](arg_type i) { res += n_data[i]; });
+    return res;
+}
+
+template <typename T, arg_type... Dims>
+T
+StaticArray<T, Dims...>::min() const
+{
+    return *std::min_element(n_data.begin(), n_data.end());
+}
+
+template <typename T, arg_type... Dims>
+T
+StaticArray<T, Dims...>::max() const
+{
+    return *std::max_element(n_data.begin(), n_data.end());
+}
+
+template <typename T, arg_type... Dims>
+void
+StaticArray<T, Dims...>::print_data() const
+{
+    constexpr arg_type cols = dims[ndim - 1];
+    for (arg_type i = 0; i < total; ++i) {
+        std::cout << n_data[i] << ((i + 1) % cols == 0 ? '\n' : ' ');
+    }
+    std::cout << std::flush;
+}
+
+}
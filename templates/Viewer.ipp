@@ -1,128 +1,354 @@
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace SamH::NumC
 {
+
+namespace detail
+{
+    // Square tile of a permuted copy, both the source and destination tile stay in L1
+    constexpr arg_type TRANSPOSE_TILE = 32;
+
+    // out[i * out_i + j] = in[i + j * in_j] for a rows x cols tile whose source is
+    // contiguous along i; 4x4 and 2x2 blocks are transposed in registers
+    template <typename T>
+    void transpose_tile(const T* in, arg_type in_j, T* out, arg_type out_i, arg_type rows, arg_type cols)
+    {
+        arg_type i0 = 0, j0 = 0;
+#if defined(__SSE2__)
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 4) {
+            for (; i0 + 4 <= rows; i0 += 4) {
+                for (arg_type j = 0; j + 4 <= cols; j += 4) {
+                    const float* src = reinterpret_cast<const float*>(in + i0 + j * in_j);
+                    const arg_type step = in_j;
+                    __m128 r0 = _mm_loadu_ps(src);
+                    __m128 r1 = _mm_loadu_ps(src + step);
+                    __m128 r2 = _mm_loadu_ps(src + 2 * step);
+                    __m128 r3 = _mm_loadu_ps(src + 3 * step);
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                    float* dst = reinterpret_cast<float*>(out + i0 * out_i + j);
+                    _mm_storeu_ps(dst, r0);
+                    _mm_storeu_ps(dst + out_i, r1);
+                    _mm_storeu_ps(dst + 2 * out_i, r2);
+                    _mm_storeu_ps(dst + 3 * out_i, r3);
+                }
+            }
+            j0 = cols - cols % 4;
+        } else if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 8) {
+            for (; i0 + 2 <= rows; i0 += 2) {
+                for (arg_type j = 0; j + 2 <= cols; j += 2) {
+                    const double* src = reinterpret_cast<const double*>(in + i0 + j * in_j);
+                    const __m128d c0 = _mm_loadu_pd(src);
+                    const __m128d c1 = _mm_loadu_pd(src + in_j);
+                    double* dst = reinterpret_cast<double*>(out + i0 * out_i + j);
+                    _mm_storeu_pd(dst, _mm_unpacklo_pd(c0, c1));
+                    _mm_storeu_pd(dst + out_i, _mm_unpackhi_pd(c0, c1));
+                }
+            }
+            j0 = cols - cols % 2;
+        }
+#endif
+        // Remaining right-hand columns of the vectorized rows, then the remaining rows
+        for (arg_type i = 0; i < i0; ++i) {
+            for (arg_type j = j0; j < cols; ++j) out[i * out_i + j] = in[i + j * in_j];
+        }
+        for (arg_type j = 0; j < cols; ++j) {
+            for (arg_type i = i0; i < rows; ++i) out[i * out_i + j] = in[i + j * in_j];
+        }
+    }
+
+    // Data offset of the `index`-th combination of the listed axes, taken in row-major order
+    inline arg_type axes_offset(arg_type index, const Shape& shape, const Shape& strides,
+                                const std::vector<arg_type>& axes)
+    {
+        arg_type offset = 0;
+        for (arg_type a = static_cast<arg_type>(axes.size()) - 1; a >= 0; --a) {
+            const arg_type d = axes[a];
+            offset += (index % shape[d]) * strides[d];
+            index /= shape[d];
+        }
+        return offset;
+    }
+}
 template <typename T>
-Viewer<T>::Viewer(T* dt_b, T* dt_e, const std::vector<arg_type>& shape, const std::vector<Slice>& slices)
+Viewer<T>::Viewer(T* dt_b, T* dt_e, const Shape& parent_shape, const std::vector<Slice>& slices)
     : data_begin(dt_b)
     , data_end(dt_e)
-    , dims(shape)
+    , dims(parent_shape)
     , views(slices)
-{}
+    , offset(0)
+{
+    if (views.size() > dims.size()) {
+        throw std::invalid_argument("Too many slices for the array's dimensions.");
+    }
+    // Dimensions without an explicit slice are taken whole
+    for (std::size_t d = views.size(); d < dims.size(); ++d) {
+        views.push_back(Slice(0, dims[d]));
+    }
+
+    const Shape parent_strides = dims.strides();
+    shape   = Shape(views.size());
+    strides = Shape(views.size());
+    for (std::size_t d = 0; d < views.size(); ++d) {
+        shape[d]   = views[d].size();
+        strides[d] = views[d].step()  * parent_strides[d];
+        offset    += views[d].start() * parent_strides[d];
+    }
+}
 
 template <typename T>
 T 
-Viewer<T>::operator()(const std::vector<arg_type>& coords) const {
-    arg_type dim_size = dims.size();
-    if (static_cast<arg_type>(coords.size()) != dim_size) {
+Viewer<T>::operator()(const Shape& coords) const {
+    if (coords.size() != shape.size()) {
         throw std::invalid_argument("Incorrect number of coordinates provided.");
     }
 
-    std::vector<arg_type> strides(dim_size);
-    strides[dim_size - 1] = 1;
-    for (int i = dim_size - 2; i >= 0; --i)
-        strides[i] = strides[i + 1] * dims[i + 1];
-
-    arg_type index = 0;
-    for (arg_type x = 0; x < dim_size; ++x)
-        index += views[x][coords[x]] * strides[x];
+    arg_type index = offset;
+    for (std::size_t x = 0; x < shape.size(); ++x) {
+        if (coords[x] >= shape[x]) throw std::out_of_range("Slice::Index out of range");
+        index += coords[x] * strides[x];
+    }
 
     return *(data_begin + index);
 }
 
 template <typename T>
 T& 
-Viewer<T>::operator()(const std::vector<arg_type>& coords) {
-    arg_type dim_size = dims.size();
-    if (static_cast<arg_type>(coords.size()) != dim_size) {
+Viewer<T>::operator()(const Shape& coords) {
+    if (coords.size() != shape.size()) {
         throw std::invalid_argument("Incorrect number of coordinates provided.");
     }
-    
-    std::vector<arg_type> strides(dim_size);
-    strides[dim_size - 1] = 1;
-    for (int i = dim_size - 2; i >= 0; --i)
-        strides[i] = strides[i + 1] * dims[i + 1];
 
-    arg_type index = 0;
-    for (arg_type x = 0; x < dim_size; ++x)
-        index += views[x][coords[x]] * strides[x];
+    arg_type index = offset;
+    for (std::size_t x = 0; x < shape.size(); ++x) {
+        if (coords[x] >= shape[x]) throw std::out_of_range("Slice::Index out of range");
+        index += coords[x] * strides[x];
+    }
 
     return *(data_begin + index);
 }
 
 template <typename T>
-void Viewer<T>::operator=(const std::vector<T>& data)
+arg_type
+Viewer<T>::size() const
 {
-    arg_type total_size = 1;
-    std::vector<arg_type> view_shape;
-    view_shape.reserve(views.size());
-
-    for (auto& slice : views) {
-        arg_type current_dim_size = slice.size();
-        if (current_dim_size == 0) {
-            total_size = 0;
-            break;
-        }
-        total_size *= current_dim_size;
-        view_shape.push_back(current_dim_size);
-    }
+    return shape.empty() ? 0 : shape.total();
+}
 
-    if (static_cast<arg_type>(data.size()) != total_size) {
-        throw std::invalid_argument("Input data size does not match the view's size.");
-    }
-    
+template <typename T>
+template <typename F>
+void
+Viewer<T>::for_each_offset(F func) const
+{
+    const arg_type total_size = size();
     if (total_size == 0) {
         return;
     }
 
-    std::vector<arg_type> coords(views.size(), 0);
+    // Walk the view with a coordinate counter, moving the data offset by the
+    // cached strides instead of recomputing it for every element
+    const arg_type ndim = shape.size();
+    Shape coords(ndim, 0);
+    arg_type index = offset;
     for (arg_type i = 0; i < total_size; ++i) {
-        (*this)(coords) = data[i];
-        
-        for (int j = view_shape.size() - 1; j >= 0; --j) {
-            ++coords[j];
-            if (coords[j] < view_shape[j]) {
+        func(i, index);
+        for (arg_type j = ndim - 1; j >= 0; --j) {
+            index += strides[j];
+            if (++coords[j] < shape[j]) {
                 break;
             }
+            index -= strides[j] * shape[j];
             coords[j] = 0;
         }
     }
 }
 
 template <typename T>
-void Viewer<T>::operator=(const T& scalar_value)
+Viewer<T>
+Viewer<T>::transpose() const
 {
-    arg_type total_size = 1;
-    std::vector<arg_type> view_shape;
-    view_shape.reserve(views.size());
+    Shape axes(shape.size());
+    for (std::size_t d = 0; d < axes.size(); ++d) axes[d] = axes.size() - 1 - d;
+    return transpose(axes);
+}
 
-    for (auto& slice : views) {
-        const arg_type current_dim_size = slice.size();
-        if (current_dim_size == 0) {
-            total_size = 0;
-            break;
-        }
-        total_size *= current_dim_size;
-        view_shape.push_back(current_dim_size);
+template <typename T>
+Viewer<T>
+Viewer<T>::transpose(const Shape& axes) const
+{
+    const arg_type ndim = shape.size();
+    if (static_cast<arg_type>(axes.size()) != ndim) {
+        throw std::invalid_argument("Transpose::Axes don't match the array's dimensions");
+    }
+
+    Viewer<T> res(*this);
+    std::vector<bool> seen(ndim, false);
+    for (arg_type d = 0; d < ndim; ++d) {
+        const arg_type axis = axes[d] < 0 ? axes[d] + ndim : axes[d];
+        if (axis < 0 || axis >= ndim) throw std::out_of_range("Transpose::Axis out of range");
+        if (seen[axis]) throw std::invalid_argument("Transpose::Repeated axis");
+        seen[axis] = true;
+
+        res.shape[d]   = shape[axis];
+        res.strides[d] = strides[axis];
+        res.views[d]   = views[axis];
+    }
+    return res;
+}
+
+template <typename T>
+Viewer<T>
+Viewer<T>::swapaxes(arg_type first, arg_type second) const
+{
+    const arg_type ndim = shape.size();
+    if (first < 0) first += ndim;
+    if (second < 0) second += ndim;
+    if (first < 0 || first >= ndim || second < 0 || second >= ndim) {
+        throw std::out_of_range("Swapaxes::Axis out of range");
     }
 
+    Shape axes(ndim);
+    for (arg_type d = 0; d < ndim; ++d) axes[d] = d;
+    std::swap(axes[first], axes[second]);
+    return transpose(axes);
+}
+
+template <typename T>
+Viewer<T>
+Viewer<T>::moveaxis(arg_type source, arg_type destination) const
+{
+    const arg_type ndim = shape.size();
+    if (source < 0) source += ndim;
+    if (destination < 0) destination += ndim;
+    if (source < 0 || source >= ndim || destination < 0 || destination >= ndim) {
+        throw std::out_of_range("Moveaxis::Axis out of range");
+    }
+
+    Shape axes;
+    for (arg_type d = 0; d < ndim; ++d) {
+        if (d != source) axes.push_back(d);
+    }
+    axes.insert(axes.data() + destination, source);
+    return transpose(axes);
+}
+
+template <typename T>
+bool
+Viewer<T>::is_contiguous() const
+{
+    arg_type expected = 1;
+    for (arg_type d = static_cast<arg_type>(shape.size()) - 1; d >= 0; --d) {
+        if (shape[d] != 1 && strides[d] != expected) return false;
+        expected *= shape[d];
+    }
+    return true;
+}
+
+template <typename T>
+void
+Viewer<T>::copy_to(T* dst) const
+{
+    const arg_type total_size = size();
     if (total_size == 0) {
         return;
     }
+    const T* src = data_begin + offset;
+    if (is_contiguous()) {
+        std::copy(src, src + total_size, dst);
+        return;
+    }
 
-    std::vector<arg_type> coords(views.size(), 0);
-    for (arg_type i = 0; i < total_size; ++i) {
-        (*this)(coords) = scalar_value;
-        for (int j = view_shape.size() - 1; j >= 0; --j) {
-            ++coords[j];
-            if (coords[j] < view_shape[j]) {
-                break;
+    const arg_type ndim = shape.size();
+    const arg_type last = ndim - 1;
+
+    // Source axis with the smallest stride; when it is not the output's innermost axis
+    // the copy is a batch of 2-D transposes between the two
+    arg_type inner = -1;
+    for (arg_type d = 0; d < ndim; ++d) {
+        if (shape[d] > 1 && (inner < 0 || std::abs(strides[d]) < std::abs(strides[inner]))) inner = d;
+    }
+
+    if (inner < 0 || inner == last || shape[last] == 1 || std::abs(strides[inner]) == std::abs(strides[last])) {
+        // Rows along the innermost output axis, each a strided gather
+        const arg_type len = shape[last];
+        const arg_type step = strides[last];
+        std::vector<arg_type> outer_axes;
+        for (arg_type d = 0; d < last; ++d) outer_axes.push_back(d);
+
+        Parallel::parallel_for(0, total_size / len, [&](arg_type b, arg_type e) {
+            for (arg_type r = b; r < e; ++r) {
+                const T* row = src + detail::axes_offset(r, shape, strides, outer_axes);
+                T* out = dst + r * len;
+                if (step == 1) std::copy(row, row + len, out);
+                else for (arg_type j = 0; j < len; ++j) out[j] = row[j * step];
+            }
+        }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / len));
+        return;
+    }
+
+    const Shape out_strides = shape.strides();
+    std::vector<arg_type> outer_axes;
+    for (arg_type d = 0; d < last; ++d) {
+        if (d != inner) outer_axes.push_back(d);
+    }
+
+    const arg_type rows = shape[inner], cols = shape[last];
+    const arg_type in_i = strides[inner], in_j = strides[last];
+    const arg_type out_i = out_strides[inner];
+    const arg_type tiles_i = (rows + detail::TRANSPOSE_TILE - 1) / detail::TRANSPOSE_TILE;
+    const arg_type tiles_j = (cols + detail::TRANSPOSE_TILE - 1) / detail::TRANSPOSE_TILE;
+    const arg_type tiles = tiles_i * tiles_j;
+    const arg_type outer_count = total_size / (rows * cols);
+
+    Parallel::parallel_for(0, outer_count * tiles, [&](arg_type b, arg_type e) {
+        for (arg_type t = b; t < e; ++t) {
+            const arg_type o = t / tiles;
+            const arg_type ti = (t % tiles) / tiles_j, tj = t % tiles_j;
+            const arg_type i0 = ti * detail::TRANSPOSE_TILE, j0 = tj * detail::TRANSPOSE_TILE;
+            const arg_type h = std::min(detail::TRANSPOSE_TILE, rows - i0);
+            const arg_type w = std::min(detail::TRANSPOSE_TILE, cols - j0);
+
+            const T* in = src + detail::axes_offset(o, shape, strides, outer_axes) + i0 * in_i + j0 * in_j;
+            T* out = dst + detail::axes_offset(o, shape, out_strides, outer_axes) + i0 * out_i + j0;
+            if (in_i == 1) {
+                detail::transpose_tile(in, in_j, out, out_i, h, w);
+            } else {
+                for (arg_type j = 0; j < w; ++j) {
+                    for (arg_type i = 0; i < h; ++i) out[i * out_i + j] = in[i * in_i + j * in_j];
+                }
             }
-            coords[j] = 0;
         }
+    }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / (detail::TRANSPOSE_TILE * detail::TRANSPOSE_TILE)));
+}
+
+template <typename T>
+Array<T>
+Viewer<T>::ascontiguous() const
+{
+    return Array<T>(*this);
+}
+
+template <typename T>
+void Viewer<T>::operator=(const std::vector<T>& data)
+{
+    if (static_cast<arg_type>(data.size()) != size()) {
+        throw std::invalid_argument("Input data size does not match the view's size.");
     }
+
+    for_each_offset([&](arg_type i, arg_type index) { data_begin[index] = data[i]; });
+}
+
+template <typename T>
+void Viewer<T>::operator=(const T& scalar_value)
+{
+    for_each_offset([&](arg_type, arg_type index) { data_begin[index] = scalar_value; });
 }
 
 template <typename T>
@@ -165,4 +391,88 @@ Viewer<T>::operator/(const Viewer<T>& rhv) const
     return arr1 / arr2;
 }
 
+// ----------------- CONST VIEWER -----------------
+// The wrapped Viewer holds non-const pointers for its own sake only; nothing here
+// writes through them
+
+template <typename T>
+ConstViewer<T>::ConstViewer(const T* dt_b, const T* dt_e, const Shape& parent_shape, const std::vector<Slice>& slices)
+    : c_view(const_cast<T*>(dt_b), const_cast<T*>(dt_e), parent_shape, slices)
+{}
+
+template <typename T>
+ConstViewer<T>::ConstViewer(const Viewer<T>& view)
+    : c_view(view)
+{}
+
+template <typename T>
+T
+ConstViewer<T>::operator()(const Shape& coords) const
+{
+    return c_view(coords);
+}
+
+template <typename T>
+arg_type
+ConstViewer<T>::size() const
+{
+    return c_view.size();
+}
+
+template <typename T>
+const Shape&
+ConstViewer<T>::shape() const
+{
+    return c_view.shape;
+}
+
+template <typename T>
+bool
+ConstViewer<T>::is_contiguous() const
+{
+    return c_view.is_contiguous();
+}
+
+template <typename T>
+ConstViewer<T>
+ConstViewer<T>::transpose() const
+{
+    return ConstViewer<T>(c_view.transpose());
+}
+
+template <typename T>
+ConstViewer<T>
+ConstViewer<T>::transpose(const Shape& axes) const
+{
+    return ConstViewer<T>(c_view.transpose(axes));
+}
+
+template <typename T>
+ConstViewer<T>
+ConstViewer<T>::swapaxes(arg_type first, arg_type second) const
+{
+    return ConstViewer<T>(c_view.swapaxes(first, second));
+}
+
+template <typename T>
+ConstViewer<T>
+ConstViewer<T>::moveaxis(arg_type source, arg_type destination) const
+{
+    return ConstViewer<T>(c_view.moveaxis(source, destination));
+}
+
+template <typename T>
+void
+ConstViewer<T>::copy_to(T* dst) const
+{
+    c_view.copy_to(dst);
+}
+
+template <typename T>
+Array<T>
+ConstViewer<T>::ascontiguous() const
+{
+    return c_view.ascontiguous();
+}
+
 }
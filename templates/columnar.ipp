@@ -0,0 +1,726 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace SamH::NumC::Columnar
+{
+
+namespace detail
+{
+    constexpr char MAGIC[8] = {'N', 'U', 'M', 'C', 'C', 'O', 'L', '1'};
+    constexpr std::int64_t TRAILER_SIZE = sizeof(std::int64_t) + sizeof(MAGIC);
+
+    template <typename T>
+    void put(std::vector<char>& out, const T& value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    T get(const char*& in)
+    {
+        // Any byte other than 0 or 1 isn't a valid bool, so booleans are tested instead
+        if constexpr (std::is_same_v<T, bool>) return *in++ != 0;
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return value;
+    }
+
+    // Everything read back from a file goes through these: they throw rather than
+    // step past `end`
+    inline void require(const char* in, const char* end, std::int64_t bytes)
+    {
+        if (bytes < 0 || end - in < bytes) throw std::runtime_error("Columnar::Truncated or corrupted file");
+    }
+
+    template <typename T>
+    T get(const char*& in, const char* end)
+    {
+        require(in, end, sizeof(T));
+        return get<T>(in);
+    }
+
+    template <typename T>
+    bool is_nan(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>) return std::isnan(value);
+        else return false;
+    }
+
+    // Integers widened to 64 bits so that frame and delta arithmetic wraps consistently
+    template <typename T>
+    std::uint64_t to_bits(T value)
+    {
+        if constexpr (std::is_signed_v<T>) return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+        else return static_cast<std::uint64_t>(value);
+    }
+
+    template <typename T>
+    T from_bits(std::uint64_t bits)
+    {
+        if constexpr (std::is_signed_v<T>) return static_cast<T>(static_cast<std::int64_t>(bits));
+        else return static_cast<T>(bits);
+    }
+
+    inline int bit_width(std::uint64_t value)
+    {
+        return value ? 64 - __builtin_clzll(value) : 0;
+    }
+
+    inline std::int64_t packed_bytes(arg_type n, int width)
+    {
+        return (static_cast<std::int64_t>(n) * width + 63) / 64 * 8;
+    }
+
+    inline void pack(const std::uint64_t* src, arg_type n, int width, std::vector<char>& out)
+    {
+        // Zero-width values (constant deltas) take no bytes; unpack emits zeros for them
+        if (width == 0) return;
+        std::vector<std::uint64_t> words(packed_bytes(n, width) / 8, 0);
+        std::uint64_t bit = 0;
+        for (arg_type i = 0; i < n; ++i, bit += width) {
+            const std::uint64_t w = bit >> 6;
+            const int s = bit & 63;
+            words[w] |= src[i] << s;
+            if (s + width > 64) words[w + 1] |= src[i] >> (64 - s);
+        }
+        const char* bytes = reinterpret_cast<const char*>(words.data());
+        out.insert(out.end(), bytes, bytes + words.size() * 8);
+    }
+
+    template <typename F>
+    void unpack(const char* in, arg_type n, int width, F&& emit)
+    {
+        if (width == 0) {
+            for (arg_type i = 0; i < n; ++i) emit(i, 0);
+            return;
+        }
+        const std::uint64_t mask = width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+        std::uint64_t bit = 0;
+        for (arg_type i = 0; i < n; ++i, bit += width) {
+            const char* word = in + (bit >> 6) * 8;
+            const int s = bit & 63;
+            std::uint64_t v;
+            std::memcpy(&v, word, 8);
+            v >>= s;
+            if (s + width > 64) {
+                std::uint64_t next;
+                std::memcpy(&next, word + 8, 8);
+                v |= next << (64 - s);
+            }
+            emit(i, v & mask);
+        }
+    }
+
+    inline void put_varint(std::vector<char>& out, std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    inline std::uint64_t get_varint(const char*& in, const char* end)
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const unsigned char byte = get<unsigned char>(in, end);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("Columnar::Corrupted chunk encoding");
+    }
+
+    // Bit width byte of a packed payload, with room for n values of that width after it
+    inline int get_width(const char*& in, const char* end, arg_type n)
+    {
+        const int width = get<unsigned char>(in, end);
+        if (width > 64) throw std::runtime_error("Columnar::Corrupted chunk encoding");
+        require(in, end, packed_bytes(n, width));
+        return width;
+    }
+
+    template <typename T>
+    ChunkInfo<T> zone_map(const T* data, arg_type n)
+    {
+        ChunkInfo<T> info{0, 0, n, 0, PLAIN, T(), T(), sum_type<T>()};
+        for (arg_type i = 0; i < n; ++i) {
+            const T v = data[i];
+            if (is_nan(v)) continue;
+            if (info.valid == 0 || v < info.min) info.min = v;
+            if (info.valid == 0 || v > info.max) info.max = v;
+            info.sum += static_cast<sum_type<T>>(v);
+            ++info.valid;
+        }
+        return info;
+    }
+
+    // The zone map can't tell -0.0 from 0.0, so floating chunks with min == max are
+    // checked for one bit pattern before being stored as a single value
+    template <typename T>
+    bool is_constant(const T* data, arg_type n)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            const bool sign = std::signbit(data[0]);
+            return std::all_of(data, data + n, [sign](T v) { return std::signbit(v) == sign; });
+        } else {
+            return true;
+        }
+    }
+
+    // Appends the payload of one chunk and records its encoding in info
+    template <typename T>
+    void encode(const T* data, arg_type n, ChunkInfo<T>& info, bool compress, std::vector<char>& out)
+    {
+        info.encoding = PLAIN;
+        if (compress && n > 0) {
+            if constexpr (std::is_same_v<T, bool>) {
+                info.encoding = RLE;
+                out.push_back(data[0]);
+                arg_type run = 1;
+                for (arg_type i = 1; i < n; ++i) {
+                    if (data[i] == data[i - 1]) {
+                        ++run;
+                    } else {
+                        put_varint(out, run);
+                        run = 1;
+                    }
+                }
+                put_varint(out, run);
+                return;
+            } else {
+                if (info.valid == n && !(info.min < info.max) && is_constant(data, n)) {
+                    info.encoding = CONSTANT;
+                    return;
+                }
+                if constexpr (std::is_integral_v<T>) {
+                    const std::uint64_t base = to_bits(info.min);
+                    const int frame_width = bit_width(to_bits(info.max) - base);
+
+                    std::vector<std::uint64_t> deltas(n - 1);
+                    std::int64_t low = std::numeric_limits<std::int64_t>::max();
+                    for (arg_type i = 1; i < n; ++i) {
+                        deltas[i - 1] = to_bits(data[i]) - to_bits(data[i - 1]);
+                        low = std::min(low, static_cast<std::int64_t>(deltas[i - 1]));
+                    }
+                    std::uint64_t spread = 0;
+                    for (std::uint64_t& d : deltas) {
+                        d -= static_cast<std::uint64_t>(low);
+                        spread = std::max(spread, d);
+                    }
+                    const int delta_width = bit_width(spread);
+
+                    const std::int64_t plain = static_cast<std::int64_t>(n) * sizeof(T);
+                    const std::int64_t frame = 1 + packed_bytes(n, frame_width);
+                    const std::int64_t delta = 17 + packed_bytes(n - 1, delta_width);
+
+                    if (delta < frame && delta < plain) {
+                        info.encoding = DELTA;
+                        put(out, to_bits(data[0]));
+                        put(out, static_cast<std::uint64_t>(low));
+                        out.push_back(static_cast<char>(delta_width));
+                        pack(deltas.data(), n - 1, delta_width, out);
+                        return;
+                    }
+                    if (frame < plain) {
+                        info.encoding = FRAME;
+                        out.push_back(static_cast<char>(frame_width));
+                        std::vector<std::uint64_t> offsets(n);
+                        for (arg_type i = 0; i < n; ++i) offsets[i] = to_bits(data[i]) - base;
+                        pack(offsets.data(), n, frame_width, out);
+                        return;
+                    }
+                }
+            }
+        }
+        const char* bytes = reinterpret_cast<const char*>(data);
+        out.insert(out.end(), bytes, bytes + n * sizeof(T));
+    }
+
+    // Fills out[0, info.count) from the info.bytes of payload at in. read_footer has
+    // already bounded count by the chunk size.
+    template <typename T>
+    void decode_values(const char* in, const ChunkInfo<T>& info, T* out)
+    {
+        const arg_type n = info.count;
+        const char* end = in + info.bytes;
+        switch (info.encoding) {
+            case PLAIN:
+                require(in, end, n * static_cast<std::int64_t>(sizeof(T)));
+                if constexpr (std::is_same_v<T, bool>) std::transform(in, in + n, out, [](char b) { return b != 0; });
+                else std::memcpy(static_cast<void*>(out), in, n * sizeof(T));
+                return;
+            case CONSTANT:
+                std::fill(out, out + n, info.min);
+                return;
+            case RLE: {
+                bool value = get<char>(in, end) != 0;
+                for (arg_type i = 0; i < n; value = !value) {
+                    const std::uint64_t run = get_varint(in, end);
+                    if (run == 0 || run > static_cast<std::uint64_t>(n - i)) {
+                        throw std::runtime_error("Columnar::Corrupted chunk encoding");
+                    }
+                    std::fill(out + i, out + i + run, static_cast<T>(value));
+                    i += run;
+                }
+                return;
+            }
+            case FRAME:
+                if constexpr (std::is_integral_v<T>) {
+                    const int width = get_width(in, end, n);
+                    const std::uint64_t base = to_bits(info.min);
+                    unpack(in, n, width, [&](arg_type i, std::uint64_t v) { out[i] = from_bits<T>(base + v); });
+                    return;
+                }
+                break;
+            case DELTA:
+                if constexpr (std::is_integral_v<T>) {
+                    std::uint64_t value = get<std::uint64_t>(in, end);
+                    const std::uint64_t low = get<std::uint64_t>(in, end);
+                    const int width = get_width(in, end, n - 1);
+                    out[0] = from_bits<T>(value);
+                    unpack(in, n - 1, width, [&](arg_type i, std::uint64_t v) {
+                        value += low + v;
+                        out[i + 1] = from_bits<T>(value);
+                    });
+                    return;
+                }
+                break;
+        }
+        throw std::runtime_error("Columnar::Corrupted chunk encoding");
+    }
+
+    // Encodes chunks a batch at a time across the thread pool and streams them out.
+    // view(begin, count, scratch) returns the chunk's values, using scratch if it has to copy.
+    template <typename T, typename View>
+    void write_column(const std::string& path, const Shape& shape, arg_type n, arg_type chunk_size,
+                      bool compress, View&& view)
+    {
+        if (chunk_size <= 0) throw std::invalid_argument("Columnar::Chunk size must be positive");
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("Columnar::Can't open " + path + " for writing");
+        file.write(MAGIC, sizeof(MAGIC));
+
+        const arg_type chunks = (n + chunk_size - 1) / chunk_size;
+        const arg_type batch = Parallel::num_threads() * 4;
+        std::vector<ChunkInfo<T>> infos(chunks);
+        std::vector<std::vector<char>> payloads(batch);
+        std::int64_t offset = sizeof(MAGIC);
+
+        for (arg_type first = 0; first < chunks; first += batch) {
+            const arg_type last = std::min(chunks, first + batch);
+            Parallel::parallel_for(first, last, [&](arg_type b, arg_type e) {
+                std::unique_ptr<T[]> scratch(new T[chunk_size]);
+                for (arg_type c = b; c < e; ++c) {
+                    const arg_type begin = c * chunk_size;
+                    const arg_type count = std::min(chunk_size, n - begin);
+                    const T* values = view(begin, count, scratch.get());
+                    std::vector<char>& payload = payloads[c - first];
+                    payload.clear();
+                    infos[c] = zone_map(values, count);
+                    encode(values, count, infos[c], compress, payload);
+                }
+            }, 1);
+            for (arg_type c = first; c < last; ++c) {
+                const std::vector<char>& payload = payloads[c - first];
+                infos[c].offset = offset;
+                infos[c].bytes = payload.size();
+                file.write(payload.data(), payload.size());
+                offset += payload.size();
+            }
+        }
+
+        std::vector<char> footer;
+        footer.push_back(NumC::detail::type_kind<T>());
+        footer.push_back(static_cast<char>(sizeof(T)));
+        put<std::int64_t>(footer, shape.size());
+        for (arg_type d : shape) put<std::int64_t>(footer, d);
+        put<std::int64_t>(footer, chunk_size);
+        put<std::int64_t>(footer, chunks);
+        for (const ChunkInfo<T>& info : infos) {
+            put(footer, info.offset);
+            put(footer, info.bytes);
+            put(footer, info.count);
+            put(footer, info.valid);
+            put<std::int32_t>(footer, info.encoding);
+            put(footer, info.min);
+            put(footer, info.max);
+            put(footer, info.sum);
+        }
+        put<std::int64_t>(footer, offset);
+        footer.insert(footer.end(), MAGIC, MAGIC + sizeof(MAGIC));
+        file.write(footer.data(), footer.size());
+        if (!file) throw std::runtime_error("Columnar::Failed writing " + path);
+    }
+
+    template <typename T>
+    void read_footer(std::ifstream& file, const std::string& path, Shape& shape, arg_type& chunk_size,
+                     std::vector<ChunkInfo<T>>& chunks)
+    {
+        if (!file) throw std::runtime_error("Columnar::Can't open " + path);
+        char magic[sizeof(MAGIC)];
+        file.read(magic, sizeof(magic));
+        file.seekg(0, std::ios::end);
+        const std::int64_t end = file.tellg();
+        if (!file || end < static_cast<std::int64_t>(sizeof(MAGIC)) + TRAILER_SIZE
+            || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Columnar::" + path + " is not a NumC columnar file");
+        }
+
+        char trailer[TRAILER_SIZE];
+        file.seekg(end - TRAILER_SIZE);
+        file.read(trailer, TRAILER_SIZE);
+        const char* cursor = trailer;
+        const std::int64_t footer_offset = get<std::int64_t>(cursor);
+        if (!file || std::memcmp(cursor, MAGIC, sizeof(MAGIC)) != 0
+            || footer_offset < static_cast<std::int64_t>(sizeof(MAGIC)) || footer_offset > end - TRAILER_SIZE) {
+            throw std::runtime_error("Columnar::" + path + " has a damaged footer");
+        }
+
+        std::vector<char> footer(end - TRAILER_SIZE - footer_offset);
+        file.seekg(footer_offset);
+        file.read(footer.data(), footer.size());
+        if (!file) throw std::runtime_error("Columnar::Failed reading the footer of " + path);
+        cursor = footer.data();
+        const char* last = footer.data() + footer.size();
+        if (footer.size() < 2 || cursor[0] != NumC::detail::type_kind<T>() || cursor[1] != static_cast<char>(sizeof(T))) {
+            throw std::runtime_error("Columnar::Element type doesn't match the file");
+        }
+        cursor += 2;
+
+        // Chunk c must cover [c * chunk_size, c * chunk_size + count) of the shape and
+        // its payload must lie between the magic and the footer; readers rely on both
+        const auto damaged = [&]() { return std::runtime_error("Columnar::" + path + " has a damaged footer"); };
+        const std::int64_t ndim = get<std::int64_t>(cursor, last);
+        if (ndim < 0 || ndim > (last - cursor) / static_cast<std::int64_t>(sizeof(std::int64_t))) throw damaged();
+        shape = Shape(ndim);
+        std::int64_t total = 1;
+        for (arg_type& d : shape) {
+            d = get<std::int64_t>(cursor, last);
+            if (d < 0 || __builtin_mul_overflow(total, d, &total)) throw damaged();
+        }
+        chunk_size = get<std::int64_t>(cursor, last);
+        const std::int64_t count = get<std::int64_t>(cursor, last);
+        constexpr std::int64_t entry = 4 * sizeof(std::int64_t) + sizeof(std::int32_t) + 2 * sizeof(T) + sizeof(sum_type<T>);
+        if (chunk_size <= 0 || count < 0 || count > (last - cursor) / entry) throw damaged();
+
+        chunks.resize(count);
+        std::int64_t covered = 0;
+        for (std::int64_t c = 0; c < count; ++c) {
+            ChunkInfo<T>& info = chunks[c];
+            info.offset = get<std::int64_t>(cursor, last);
+            info.bytes = get<std::int64_t>(cursor, last);
+            info.count = get<std::int64_t>(cursor, last);
+            info.valid = get<std::int64_t>(cursor, last);
+            const std::int32_t encoding = get<std::int32_t>(cursor, last);
+            if (encoding < PLAIN || encoding > RLE) throw damaged();
+            info.encoding = static_cast<Encoding>(encoding);
+            info.min = get<T>(cursor, last);
+            info.max = get<T>(cursor, last);
+            info.sum = get<sum_type<T>>(cursor, last);
+
+            const bool full = c + 1 == count ? info.count <= chunk_size : info.count == chunk_size;
+            if (info.count <= 0 || !full || info.valid < 0 || info.valid > info.count
+                || info.offset < static_cast<std::int64_t>(sizeof(MAGIC)) || info.bytes < 0
+                || info.bytes > footer_offset - info.offset) {
+                throw damaged();
+            }
+            if (__builtin_add_overflow(covered, info.count, &covered)) throw damaged();
+        }
+        if (covered != total) throw damaged();
+    }
+
+    template <typename T>
+    bool matches(Compare op, T lhv, T rhv)
+    {
+        switch (op) {
+            case GREATER:       return lhv > rhv;
+            case GREATER_EQUAL: return lhv >= rhv;
+            case LESS:          return lhv < rhv;
+            case LESS_EQUAL:    return lhv <= rhv;
+            case EQUAL:         return lhv == rhv;
+            case NOT_EQUAL:     return lhv != rhv;
+        }
+        return false;
+    }
+}
+
+// ----------------- WRITING -----------------
+
+template <typename T>
+void
+write(const std::string& path, const Array<T>& arr, arg_type chunk_size, bool compress)
+{
+    static_assert(std::is_arithmetic_v<T>, "Columnar::write requires a numeric element type");
+    detail::write_column<T>(path, arr.shape(), arr.size(), chunk_size, compress,
+                            [&](arg_type begin, arg_type, T*) { return arr.data() + begin; });
+}
+
+inline void
+write(const std::string& path, const Mask& mask, arg_type chunk_size)
+{
+    detail::write_column<bool>(path, Shape{mask.size()}, mask.size(), chunk_size, true,
+                               [&](arg_type begin, arg_type count, bool* scratch) {
+        std::copy(mask.data.begin() + begin, mask.data.begin() + begin + count, scratch);
+        return static_cast<const bool*>(scratch);
+    });
+}
+
+inline Mask
+read_mask(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    Shape shape;
+    arg_type chunk_size;
+    std::vector<ChunkInfo<bool>> chunks;
+    detail::read_footer(file, path, shape, chunk_size, chunks);
+
+    Mask res(shape.total());
+    std::vector<char> payload;
+    std::unique_ptr<bool[]> values(new bool[chunk_size]);
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+        const ChunkInfo<bool>& info = chunks[c];
+        payload.resize(info.bytes);
+        file.seekg(info.offset);
+        file.read(payload.data(), info.bytes);
+        if (!file) throw std::runtime_error("Columnar::Failed reading a chunk");
+        detail::decode_values(payload.data(), info, values.get());
+        std::copy(values.get(), values.get() + info.count, res.data.begin() + c * chunk_size);
+    }
+    return res;
+}
+
+inline arg_type
+count_mask(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    Shape shape;
+    arg_type chunk_size;
+    std::vector<ChunkInfo<bool>> chunks;
+    detail::read_footer(file, path, shape, chunk_size, chunks);
+
+    arg_type res = 0;
+    for (const ChunkInfo<bool>& info : chunks) res += info.sum;
+    return res;
+}
+
+// ----------------- READER -----------------
+
+template <typename T>
+Reader<T>::Reader(const std::string& path)
+    : r_file(path, std::ios::binary)
+    , r_chunk_size(0)
+{
+    detail::read_footer(r_file, path, r_shape, r_chunk_size, r_chunks);
+}
+
+template <typename T>
+const Shape&
+Reader<T>::shape() const
+{
+    return r_shape;
+}
+
+template <typename T>
+arg_type
+Reader<T>::size() const
+{
+    return r_shape.total();
+}
+
+template <typename T>
+arg_type
+Reader<T>::chunk_size() const
+{
+    return r_chunk_size;
+}
+
+template <typename T>
+arg_type
+Reader<T>::chunk_count() const
+{
+    return r_chunks.size();
+}
+
+template <typename T>
+const ChunkInfo<T>&
+Reader<T>::chunk(arg_type index) const
+{
+    if (index < 0 || index >= chunk_count()) throw std::out_of_range("Columnar::Chunk index out of range");
+    return r_chunks[index];
+}
+
+template <typename T>
+void
+Reader<T>::decode(arg_type index, T* out)
+{
+    const ChunkInfo<T>& info = r_chunks[index];
+    r_payload.resize(info.bytes);
+    r_file.seekg(info.offset);
+    r_file.read(r_payload.data(), info.bytes);
+    if (!r_file) throw std::runtime_error("Columnar::Failed reading a chunk");
+    detail::decode_values(r_payload.data(), info, out);
+    ++r_decoded;
+}
+
+template <typename T>
+Array<T>
+Reader<T>::read()
+{
+    Array<T> res = Array<T>::uninitialized(r_shape);
+    for (arg_type c = 0; c < chunk_count(); ++c) decode(c, res.data() + c * r_chunk_size);
+    return res;
+}
+
+template <typename T>
+Array<T>
+Reader<T>::read_chunk(arg_type index)
+{
+    Array<T> res = Array<T>::uninitialized(Shape{chunk(index).count});
+    decode(index, res.data());
+    return res;
+}
+
+template <typename T>
+sum_type<T>
+Reader<T>::sum() const
+{
+    sum_type<T> res = sum_type<T>();
+    for (const ChunkInfo<T>& info : r_chunks) res += info.sum;
+    return res;
+}
+
+template <typename T>
+T
+Reader<T>::min() const
+{
+    const ChunkInfo<T>* best = nullptr;
+    for (const ChunkInfo<T>& info : r_chunks) {
+        if (info.valid && (!best || info.min < best->min)) best = &info;
+    }
+    if (!best) throw std::runtime_error("Columnar::No values to take the minimum of");
+    return best->min;
+}
+
+template <typename T>
+T
+Reader<T>::max() const
+{
+    const ChunkInfo<T>* best = nullptr;
+    for (const ChunkInfo<T>& info : r_chunks) {
+        if (info.valid && (!best || info.max > best->max)) best = &info;
+    }
+    if (!best) throw std::runtime_error("Columnar::No values to take the maximum of");
+    return best->max;
+}
+
+template <typename T>
+typename Reader<T>::Verdict
+Reader<T>::classify(const ChunkInfo<T>& info, Compare op, T rhv) const
+{
+    // NaN compares unequal to everything and false otherwise
+    if (info.valid == 0 || detail::is_nan(rhv)) return op == NOT_EQUAL ? ALL_MATCH : NO_MATCH;
+
+    bool none = false;
+    bool all = false;
+    switch (op) {
+        case GREATER:       none = !(info.max > rhv);  all = info.min > rhv;  break;
+        case GREATER_EQUAL: none = !(info.max >= rhv); all = info.min >= rhv; break;
+        case LESS:          none = !(info.min < rhv);  all = info.max < rhv;  break;
+        case LESS_EQUAL:    none = !(info.min <= rhv); all = info.max <= rhv; break;
+        case EQUAL:
+            none = rhv < info.min || rhv > info.max;
+            all = info.min == rhv && info.max == rhv;
+            break;
+        case NOT_EQUAL:
+            none = info.min == rhv && info.max == rhv;
+            all = rhv < info.min || rhv > info.max;
+            break;
+    }
+
+    const bool with_nan = info.valid < info.count;
+    if (op == NOT_EQUAL) {
+        if (all) return ALL_MATCH;
+        return none && !with_nan ? NO_MATCH : PARTIAL;
+    }
+    if (none) return NO_MATCH;
+    return all && !with_nan ? ALL_MATCH : PARTIAL;
+}
+
+template <typename T>
+arg_type
+Reader<T>::count(Compare op, T rhv)
+{
+    arg_type res = 0;
+    std::unique_ptr<T[]> values;
+    for (arg_type c = 0; c < chunk_count(); ++c) {
+        const ChunkInfo<T>& info = r_chunks[c];
+        const Verdict verdict = classify(info, op, rhv);
+        if (verdict == ALL_MATCH) res += info.count;
+        if (verdict != PARTIAL) continue;
+
+        if (!values) values.reset(new T[r_chunk_size]);
+        decode(c, values.get());
+        for (arg_type i = 0; i < info.count; ++i) res += detail::matches(op, values[i], rhv);
+    }
+    return res;
+}
+
+template <typename T>
+Mask
+Reader<T>::compare(Compare op, T rhv)
+{
+    Mask res(size());
+    std::unique_ptr<T[]> values;
+    for (arg_type c = 0; c < chunk_count(); ++c) {
+        const ChunkInfo<T>& info = r_chunks[c];
+        const auto first = res.data.begin() + c * r_chunk_size;
+        const Verdict verdict = classify(info, op, rhv);
+        if (verdict == ALL_MATCH) std::fill(first, first + info.count, true);
+        if (verdict != PARTIAL) continue;
+
+        if (!values) values.reset(new T[r_chunk_size]);
+        decode(c, values.get());
+        for (arg_type i = 0; i < info.count; ++i) first[i] = detail::matches(op, values[i], rhv);
+    }
+    return res;
+}
+
+template <typename T>
+Array<T>
+Reader<T>::select(Compare op, T rhv)
+{
+    std::vector<T> matched;
+    std::unique_ptr<T[]> values;
+    for (arg_type c = 0; c < chunk_count(); ++c) {
+        const ChunkInfo<T>& info = r_chunks[c];
+        const Verdict verdict = classify(info, op, rhv);
+        if (verdict == NO_MATCH) continue;
+
+        if (!values) values.reset(new T[r_chunk_size]);
+        decode(c, values.get());
+        if (verdict == ALL_MATCH) {
+            matched.insert(matched.end(), values.get(), values.get() + info.count);
+            continue;
+        }
+        for (arg_type i = 0; i < info.count; ++i) {
+            if (detail::matches(op, values[i], rhv)) matched.push_back(values[i]);
+        }
+    }
+    return Array<T>(matched);
+}
+
+template <typename T>
+arg_type
+Reader<T>::chunks_decoded() const
+{
+    return r_decoded;
+}
+
+}
@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace SamH::NumC::Global
+{
+
+namespace detail
+{
+    // Outputs computed per tap sweep, small enough to stay in L1 alongside the input window
+    constexpr arg_type CONVOLVE_BLOCK = 1024;
+
+    // Relative cost of one multiply-add on the direct path and of one N log2 N unit
+    // of transform work on the spectral path, used by AUTO
+    constexpr double DIRECT_COST = 0.3;
+    constexpr double SPECTRAL_COST = 3.0;
+
+    template <typename T> struct is_complex : std::false_type {};
+    template <typename T> struct is_complex<std::complex<T>> : std::true_type {};
+
+    template <typename T>
+    T conj_value(const T& value)
+    {
+        if constexpr (is_complex<T>::value) return std::conj(value);
+        else return value;
+    }
+
+    template <typename T, typename S>
+    T from_spectral(const S& value)
+    {
+        if constexpr (is_complex<T>::value) return T(value);
+        else if constexpr (std::is_integral_v<T>) return static_cast<T>(std::llround(value));
+        else return static_cast<T>(value);
+    }
+
+    // y[0..n) += a * x[0..n)
+    template <typename T>
+    void axpy(T a, const T* x, T* y, arg_type n)
+    {
+        for (arg_type i = 0; i < n; ++i) y[i] += a * x[i];
+    }
+
+#if defined(__SSE2__)
+    inline void axpy(double a, const double* x, double* y, arg_type n)
+    {
+        const __m128d va = _mm_set1_pd(a);
+        arg_type i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128d y0 = _mm_loadu_pd(y + i);
+            __m128d y1 = _mm_loadu_pd(y + i + 2);
+            y0 = _mm_add_pd(y0, _mm_mul_pd(va, _mm_loadu_pd(x + i)));
+            y1 = _mm_add_pd(y1, _mm_mul_pd(va, _mm_loadu_pd(x + i + 2)));
+            _mm_storeu_pd(y + i, y0);
+            _mm_storeu_pd(y + i + 2, y1);
+        }
+        for (; i < n; ++i) y[i] += a * x[i];
+    }
+
+    inline void axpy(float a, const float* x, float* y, arg_type n)
+    {
+        const __m128 va = _mm_set1_ps(a);
+        arg_type i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m128 y0 = _mm_loadu_ps(y + i);
+            __m128 y1 = _mm_loadu_ps(y + i + 4);
+            y0 = _mm_add_ps(y0, _mm_mul_ps(va, _mm_loadu_ps(x + i)));
+            y1 = _mm_add_ps(y1, _mm_mul_ps(va, _mm_loadu_ps(x + i + 4)));
+            _mm_storeu_ps(y + i, y0);
+            _mm_storeu_ps(y + i + 4, y1);
+        }
+        for (; i < n; ++i) y[i] += a * x[i];
+    }
+#endif
+
+    // First full-overlap index and length of the requested output
+    inline void output_range(arg_type n, arg_type k, ConvolveMode mode, arg_type& start, arg_type& len)
+    {
+        const arg_type full = n + k - 1;
+        switch (mode) {
+            case FULL:
+                start = 0;
+                len = full;
+                break;
+            case SAME:
+                len = std::max(n, k);
+                start = (full - len) / 2;
+                break;
+            case VALID:
+                len = std::max(n, k) - std::min(n, k) + 1;
+                start = std::min(n, k) - 1;
+                break;
+            default:
+                throw std::invalid_argument("Convolve::Unknown mode");
+        }
+    }
+
+    // out[f - f_begin] += sum_t x[f - k + 1 + t] * hr[t] for full indices f in [f_begin, f_end),
+    // hr being the reversed kernel. One contiguous axpy per tap, clipped at the signal edges.
+    template <typename T>
+    void direct_accumulate(const T* x, arg_type n, const T* hr, arg_type k,
+                           T* out, arg_type f_begin, arg_type f_end)
+    {
+        for (arg_type t = 0; t < k; ++t) {
+            const arg_type lo = std::max(f_begin, k - 1 - t);
+            const arg_type hi = std::min(f_end, n + k - 1 - t);
+            if (lo < hi) axpy(hr[t], x + lo - k + 1 + t, out + lo - f_begin, hi - lo);
+        }
+    }
+
+    template <typename T>
+    void direct_1d(const T* x, arg_type n, const T* h, arg_type k, T* out, arg_type start, arg_type len)
+    {
+        const std::vector<T> hr(std::make_reverse_iterator(h + k), std::make_reverse_iterator(h));
+        Parallel::parallel_for(0, len, [&](arg_type b, arg_type e) {
+            for (arg_type bb = b; bb < e; bb += CONVOLVE_BLOCK) {
+                const arg_type ee = std::min(e, bb + CONVOLVE_BLOCK);
+                direct_accumulate(x, n, hr.data(), k, out + bb, start + bb, start + ee);
+            }
+        }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / k));
+    }
+
+    inline arg_type next_pow2(arg_type n)
+    {
+        arg_type p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Block transform size minimizing the overlap-save cost; returns the cost through `cost`
+    inline arg_type spectral_size(arg_type k, arg_type len, double& cost)
+    {
+        const arg_type cap = next_pow2(len + k - 1);
+        arg_type best = 0;
+        cost = 0.0;
+        for (arg_type N = next_pow2(2 * k); ; N <<= 1) {
+            const arg_type seg = N - k + 1;
+            const arg_type blocks = (len + seg - 1) / seg;
+            const double c = blocks * (SPECTRAL_COST * N * std::log2(static_cast<double>(N)) + N);
+            if (best == 0 || c < cost) {
+                best = N;
+                cost = c;
+            }
+            if (N >= cap) break;
+        }
+        return best;
+    }
+
+    // Overlap-save: every output block reads its own window of N inputs, so blocks are
+    // independent and written without synchronization
+    template <typename T>
+    void spectral_1d(const T* x, arg_type n, const T* h, arg_type k, T* out, arg_type start, arg_type len, arg_type N)
+    {
+        using FFT::complex;
+        const arg_type seg = N - k + 1;
+        const arg_type blocks = (len + seg - 1) / seg;
+
+        if constexpr (is_complex<T>::value) {
+            const auto plan = FFT::Plan::get(N);
+            std::vector<complex> H(N, complex(0.0, 0.0));
+            for (arg_type j = 0; j < k; ++j) H[j] = complex(h[j]);
+            plan->execute(H.data(), H.data(), false);
+            const double scale = 1.0 / N;
+
+            Parallel::parallel_for(0, blocks, [&](arg_type b, arg_type e) {
+                std::vector<complex> w(N);
+                for (arg_type blk = b; blk < e; ++blk) {
+                    const arg_type base = start + blk * seg - k + 1;
+                    for (arg_type m = 0; m < N; ++m) {
+                        const arg_type idx = base + m;
+                        w[m] = (idx >= 0 && idx < n) ? complex(x[idx]) : complex(0.0, 0.0);
+                    }
+                    plan->execute(w.data(), w.data(), false);
+                    for (arg_type m = 0; m < N; ++m) w[m] *= H[m];
+                    plan->execute(w.data(), w.data(), true);
+                    const arg_type count = std::min(seg, len - blk * seg);
+                    for (arg_type m = 0; m < count; ++m) out[blk * seg + m] = from_spectral<T>(w[k - 1 + m] * scale);
+                }
+            }, 1);
+        } else {
+            const auto plan = FFT::RealPlan::get(N);
+            std::vector<double> hbuf(N, 0.0);
+            for (arg_type j = 0; j < k; ++j) hbuf[j] = static_cast<double>(h[j]);
+            std::vector<complex> H(N / 2 + 1);
+            plan->forward(hbuf.data(), H.data());
+
+            Parallel::parallel_for(0, blocks, [&](arg_type b, arg_type e) {
+                std::vector<double> w(N);
+                std::vector<complex> W(N / 2 + 1);
+                for (arg_type blk = b; blk < e; ++blk) {
+                    const arg_type base = start + blk * seg - k + 1;
+                    for (arg_type m = 0; m < N; ++m) {
+                        const arg_type idx = base + m;
+                        w[m] = (idx >= 0 && idx < n) ? static_cast<double>(x[idx]) : 0.0;
+                    }
+                    plan->forward(w.data(), W.data());
+                    for (arg_type m = 0; m <= N / 2; ++m) W[m] *= H[m];
+                    plan->inverse(W.data(), w.data());
+                    const arg_type count = std::min(seg, len - blk * seg);
+                    for (arg_type m = 0; m < count; ++m) out[blk * seg + m] = from_spectral<T>(w[k - 1 + m]);
+                }
+            }, 1);
+        }
+    }
+
+    template <typename T>
+    Array<T> convolve_1d(const Array<T>& signal, const T* h, arg_type k, ConvolveMode mode, ConvolveMethod method)
+    {
+        const arg_type n = signal.size();
+        arg_type start, len;
+        output_range(n, k, mode, start, len);
+        Array<T> res(Shape{len}, T());
+        if (len == 0) return res;
+
+        arg_type N = 0;
+        if (method != DIRECT) {
+            double spectral_cost;
+            N = spectral_size(k, len, spectral_cost);
+            if (method == AUTO && DIRECT_COST * len * k <= spectral_cost) N = 0;
+        }
+
+        if (N == 0) direct_1d(signal.data(), n, h, k, res.data(), start, len);
+        else        spectral_1d(signal.data(), n, h, k, res.data(), start, len, N);
+        return res;
+    }
+
+    template <typename T>
+    void direct_2d(const T* x, arg_type R, arg_type C, const T* h, arg_type kr, arg_type kc, T* out,
+                   arg_type rs, arg_type rl, arg_type cs, arg_type cl)
+    {
+        // Kernel rows reversed in place so every (output row, kernel row) pair is a 1-D sweep
+        std::vector<T> hr(kr * kc);
+        for (arg_type a = 0; a < kr; ++a) {
+            for (arg_type b = 0; b < kc; ++b) hr[a * kc + b] = h[a * kc + kc - 1 - b];
+        }
+
+        Parallel::parallel_for(0, rl, [&](arg_type b, arg_type e) {
+            for (arg_type i = b; i < e; ++i) {
+                const arg_type fr = rs + i;
+                const arg_type a_lo = std::max<arg_type>(0, fr - R + 1);
+                const arg_type a_hi = std::min(kr, fr + 1);
+                for (arg_type cb = 0; cb < cl; cb += CONVOLVE_BLOCK) {
+                    const arg_type ce = std::min(cl, cb + CONVOLVE_BLOCK);
+                    for (arg_type a = a_lo; a < a_hi; ++a) {
+                        direct_accumulate(x + (fr - a) * C, C, hr.data() + a * kc, kc,
+                                          out + i * cl + cb, cs + cb, cs + ce);
+                    }
+                }
+            }
+        }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / std::max<arg_type>(1, cl * kr * kc)));
+    }
+
+    // Whole-array transform of the zero-padded inputs; the row and column passes are
+    // batched across the thread pool by the FFT module
+    template <typename T>
+    void spectral_2d(const T* x, arg_type R, arg_type C, const T* h, arg_type kr, arg_type kc, T* out,
+                     arg_type rs, arg_type rl, arg_type cs, arg_type cl, arg_type P, arg_type Q)
+    {
+        using FFT::complex;
+        if constexpr (is_complex<T>::value) {
+            Array<complex> xp(Shape{P, Q}, complex(0.0, 0.0));
+            Array<complex> hp(Shape{P, Q}, complex(0.0, 0.0));
+            for (arg_type r = 0; r < R; ++r) for (arg_type c = 0; c < C; ++c) xp[r * Q + c] = complex(x[r * C + c]);
+            for (arg_type r = 0; r < kr; ++r) for (arg_type c = 0; c < kc; ++c) hp[r * Q + c] = complex(h[r * kc + c]);
+
+            Array<complex> X = FFT::fft2(xp);
+            const Array<complex> H = FFT::fft2(hp);
+            for (arg_type i = 0; i < X.size(); ++i) X[i] *= H[i];
+            const Array<complex> y = FFT::ifft2(X);
+            for (arg_type i = 0; i < rl; ++i) {
+                for (arg_type j = 0; j < cl; ++j) out[i * cl + j] = from_spectral<T>(y[(rs + i) * Q + cs + j]);
+            }
+        } else {
+            Array<double> xp(Shape{P, Q}, 0.0);
+            Array<double> hp(Shape{P, Q}, 0.0);
+            for (arg_type r = 0; r < R; ++r) for (arg_type c = 0; c < C; ++c) xp[r * Q + c] = static_cast<double>(x[r * C + c]);
+            for (arg_type r = 0; r < kr; ++r) for (arg_type c = 0; c < kc; ++c) hp[r * Q + c] = static_cast<double>(h[r * kc + c]);
+
+            Array<complex> X = FFT::fft(FFT::rfft(xp), 0);
+            const Array<complex> H = FFT::fft(FFT::rfft(hp), 0);
+            for (arg_type i = 0; i < X.size(); ++i) X[i] *= H[i];
+            const Array<double> y = FFT::irfft(FFT::ifft(X, 0), Q);
+            for (arg_type i = 0; i < rl; ++i) {
+                for (arg_type j = 0; j < cl; ++j) out[i * cl + j] = from_spectral<T>(y[(rs + i) * Q + cs + j]);
+            }
+        }
+    }
+
+    template <typename T>
+    Array<T> convolve_2d(const Array<T>& image, const T* h, arg_type kr, arg_type kc,
+                         ConvolveMode mode, ConvolveMethod method)
+    {
+        const arg_type R = image.shape()[0], C = image.shape()[1];
+        arg_type rs, rl, cs, cl;
+        output_range(R, kr, mode, rs, rl);
+        output_range(C, kc, mode, cs, cl);
+        Array<T> res(Shape{rl, cl}, T());
+        if (rl == 0 || cl == 0) return res;
+
+        const arg_type P = next_pow2(R + kr - 1), Q = next_pow2(C + kc - 1);
+        bool spectral = method == SPECTRAL;
+        if (method == AUTO) {
+            const double direct_cost = DIRECT_COST * rl * cl * kr * kc;
+            const double spectral_cost = 3 * SPECTRAL_COST * P * Q * std::log2(static_cast<double>(P * Q));
+            spectral = spectral_cost < direct_cost;
+        }
+
+        if (spectral) spectral_2d(image.data(), R, C, h, kr, kc, res.data(), rs, rl, cs, cl, P, Q);
+        else          direct_2d(image.data(), R, C, h, kr, kc, res.data(), rs, rl, cs, cl);
+        return res;
+    }
+
+    template <typename T>
+    void check_convolve_args(const Array<T>& first, const Array<T>& second, arg_type ndim)
+    {
+        if (static_cast<arg_type>(first.shape().size()) != ndim || static_cast<arg_type>(second.shape().size()) != ndim) {
+            throw std::invalid_argument(ndim == 1 ? "Convolve::Arrays must be 1-D" : "Convolve::Arrays must be 2-D");
+        }
+        if (first.size() == 0 || second.size() == 0) {
+            throw std::invalid_argument("Convolve::Arrays must not be empty");
+        }
+    }
+}
+
+// ----------------- 1-D -----------------
+
+template <typename T>
+Array<T>
+convolve(const Array<T>& signal, const Array<T>& kernel, ConvolveMode mode, ConvolveMethod method)
+{
+    detail::check_convolve_args(signal, kernel, 1);
+    return detail::convolve_1d(signal, kernel.data(), kernel.size(), mode, method);
+}
+
+template <typename T>
+Array<T>
+correlate(const Array<T>& signal, const Array<T>& kernel, ConvolveMode mode, ConvolveMethod method)
+{
+    detail::check_convolve_args(signal, kernel, 1);
+    // Correlation is convolution with the reversed, conjugated kernel
+    const arg_type k = kernel.size();
+    std::vector<T> h(k);
+    for (arg_type j = 0; j < k; ++j) h[j] = detail::conj_value(kernel[k - 1 - j]);
+    return detail::convolve_1d(signal, h.data(), k, mode, method);
+}
+
+// ----------------- 2-D -----------------
+
+template <typename T>
+Array<T>
+convolve2d(const Array<T>& image, const Array<T>& kernel, ConvolveMode mode, ConvolveMethod method)
+{
+    detail::check_convolve_args(image, kernel, 2);
+    return detail::convolve_2d(image, kernel.data(), kernel.shape()[0], kernel.shape()[1], mode, method);
+}
+
+template <typename T>
+Array<T>
+correlate2d(const Array<T>& image, const Array<T>& kernel, ConvolveMode mode, ConvolveMethod method)
+{
+    detail::check_convolve_args(image, kernel, 2);
+    const arg_type total = kernel.size();
+    std::vector<T> h(total);
+    for (arg_type j = 0; j < total; ++j) h[j] = detail::conj_value(kernel[total - 1 - j]);
+    return detail::convolve_2d(image, h.data(), kernel.shape()[0], kernel.shape()[1], mode, method);
+}
+
+}
@@ -0,0 +1,290 @@
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace SamH::NumC::Global
+{
+
+namespace detail
+{
+    struct ScanSum  { template <typename T> T operator()(const T& a, const T& b) const { return a + b; } };
+    struct ScanProd { template <typename T> T operator()(const T& a, const T& b) const { return a * b; } };
+    struct ScanMin  { template <typename T> T operator()(const T& a, const T& b) const { return b < a ? b : a; } };
+    struct ScanMax  { template <typename T> T operator()(const T& a, const T& b) const { return a < b ? b : a; } };
+
+#if defined(__SSE2__)
+    // In-register prefix sums: shift-and-add inside the vector, then add the running
+    // carry broadcast from the last lane of the previous vector. Returns elements done.
+    inline arg_type scan_sum_simd(const double* src, double* dst, arg_type n, double& carry)
+    {
+        __m128d c = _mm_set1_pd(carry);
+        arg_type i = 0;
+        for (; i + 2 <= n; i += 2) {
+            __m128d x = _mm_loadu_pd(src + i);
+            x = _mm_add_pd(x, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(x), 8)));
+            x = _mm_add_pd(x, c);
+            _mm_storeu_pd(dst + i, x);
+            c = _mm_unpackhi_pd(x, x);
+        }
+        carry = _mm_cvtsd_f64(c);
+        return i;
+    }
+
+    inline arg_type scan_sum_simd(const float* src, float* dst, arg_type n, float& carry)
+    {
+        __m128 c = _mm_set1_ps(carry);
+        arg_type i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 x = _mm_loadu_ps(src + i);
+            x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+            x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+            x = _mm_add_ps(x, c);
+            _mm_storeu_ps(dst + i, x);
+            c = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        carry = _mm_cvtss_f32(c);
+        return i;
+    }
+
+    inline arg_type scan_sum_simd(const std::int32_t* src, std::int32_t* dst, arg_type n, std::int32_t& carry)
+    {
+        __m128i c = _mm_set1_epi32(carry);
+        arg_type i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi32(x, c);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), x);
+            c = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        carry = _mm_cvtsi128_si32(c);
+        return i;
+    }
+
+    inline arg_type scan_sum_simd(const std::int64_t* src, std::int64_t* dst, arg_type n, std::int64_t& carry)
+    {
+        __m128i c = _mm_set1_epi64x(carry);
+        arg_type i = 0;
+        for (; i + 2 <= n; i += 2) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi64(x, c);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), x);
+            c = _mm_unpackhi_epi64(x, x);
+        }
+        carry = _mm_cvtsi128_si64(c);
+        return i;
+    }
+#endif
+
+    template <typename T>
+    constexpr bool has_simd_scan =
+#if defined(__SSE2__)
+        std::is_same_v<T, double> || std::is_same_v<T, float> ||
+        std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t>;
+#else
+        false;
+#endif
+
+    // Serial inclusive scan of one block, optionally continuing from `carry`
+    template <typename T, typename Op>
+    void scan_block(const T* src, T* dst, arg_type n, Op op, bool has_carry, T carry)
+    {
+        if (n <= 0) return;
+        arg_type i = 0;
+        if (!has_carry) {
+            carry = src[0];
+            dst[0] = carry;
+            i = 1;
+        }
+#if defined(__SSE2__)
+        if constexpr (std::is_same_v<Op, ScanSum> && has_simd_scan<T>) {
+            i += scan_sum_simd(src + i, dst + i, n - i, carry);
+        }
+#endif
+        for (; i < n; ++i) {
+            carry = op(carry, src[i]);
+            dst[i] = carry;
+        }
+    }
+
+    // Fold of one block
+    template <typename T, typename Op>
+    T reduce_block(const T* src, arg_type n, Op op)
+    {
+        T acc = src[0];
+        for (arg_type i = 1; i < n; ++i) acc = op(acc, src[i]);
+        return acc;
+    }
+
+    // Two-pass blocked scan: every thread reduces its block, the block totals are
+    // scanned serially, then every block is scanned again starting from its offset
+    template <typename T, typename Op>
+    void scan_flat(const T* src, T* dst, arg_type n, Op op)
+    {
+        const arg_type chunks = Parallel::chunk_count(n);
+        if (chunks <= 1) {
+            scan_block(src, dst, n, op, false, T());
+            return;
+        }
+
+        std::vector<T> totals(chunks);
+        Parallel::parallel_chunks(0, n, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+            totals[chunk] = reduce_block(src + b, e - b, op);
+        });
+        for (arg_type c = 1; c < chunks; ++c) totals[c] = op(totals[c - 1], totals[c]);
+
+        Parallel::parallel_chunks(0, n, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+            if (chunk == 0) scan_block(src + b, dst + b, e - b, op, false, T());
+            else            scan_block(src + b, dst + b, e - b, op, true, totals[chunk - 1]);
+        });
+    }
+
+    // Scan along one axis of an (outer, len, inner) layout
+    template <typename T, typename Op>
+    void scan_axis(const T* src, T* dst, arg_type outer, arg_type len, arg_type inner, Op op)
+    {
+        if (outer == 0 || len == 0 || inner == 0) return;
+
+        if (inner == 1) {
+            // Every outer row is a contiguous flat scan
+            if (outer >= Parallel::num_threads()) {
+                Parallel::parallel_for(0, outer, [&](arg_type b, arg_type e) {
+                    for (arg_type o = b; o < e; ++o) scan_block(src + o * len, dst + o * len, len, op, false, T());
+                }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / len));
+            } else {
+                for (arg_type o = 0; o < outer; ++o) scan_flat(src + o * len, dst + o * len, len, op);
+            }
+            return;
+        }
+
+        // Walk the axis row by row, combining contiguous inner runs with the previous row
+        auto run = [&](arg_type o, arg_type jb, arg_type je) {
+            const T* s = src + o * len * inner;
+            T* d = dst + o * len * inner;
+            for (arg_type j = jb; j < je; ++j) d[j] = s[j];
+            for (arg_type k = 1; k < len; ++k) {
+                const T* prev = d + (k - 1) * inner;
+                const T* cur  = s + k * inner;
+                T* out        = d + k * inner;
+                for (arg_type j = jb; j < je; ++j) out[j] = op(prev[j], cur[j]);
+            }
+        };
+
+        if (outer >= Parallel::num_threads()) {
+            Parallel::parallel_for(0, outer, [&](arg_type b, arg_type e) {
+                for (arg_type o = b; o < e; ++o) run(o, 0, inner);
+            }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / (len * inner)));
+        } else {
+            for (arg_type o = 0; o < outer; ++o) {
+                Parallel::parallel_for(0, inner, [&](arg_type b, arg_type e) { run(o, b, e); },
+                                       std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / len));
+            }
+        }
+    }
+
+    // Splits a shape into (outer, axis length, inner) around a normalized axis
+    inline void split_axis(const Shape& shape, arg_type& axis, arg_type& outer, arg_type& len, arg_type& inner)
+    {
+        const arg_type ndim = shape.size();
+        if (axis < 0) axis += ndim;
+        if (axis < 0 || axis >= ndim) throw std::out_of_range("Axis out of range");
+        outer = 1;
+        inner = 1;
+        for (arg_type i = 0; i < axis; ++i) outer *= shape[i];
+        for (arg_type i = axis + 1; i < ndim; ++i) inner *= shape[i];
+        len = shape[axis];
+    }
+
+    template <typename T, typename Op>
+    void scan_into(const Array<T>& arr, Array<T>& out, Op op)
+    {
+        if (out.size() != arr.size()) {
+            throw std::invalid_argument("Output array size does not match the input");
+        }
+        if (arr.size() > 0) scan_flat(arr.data(), out.data(), arr.size(), op);
+    }
+
+    template <typename T, typename Op>
+    void scan_into(const Array<T>& arr, arg_type axis, Array<T>& out, Op op)
+    {
+        if (out.shape() != arr.shape()) {
+            throw std::invalid_argument("Output array shape does not match the input");
+        }
+        arg_type outer, len, inner;
+        split_axis(arr.shape(), axis, outer, len, inner);
+        scan_axis(arr.data(), out.data(), outer, len, inner, op);
+    }
+}
+
+// ----------------- Macros -----------------
+
+#define DEFINE_CUMULATIVE_FUNC(NAME, OP) \
+template <typename T> \
+void NAME(const Array<T>& arr, Array<T>& out) { \
+    detail::scan_into(arr, out, OP()); \
+} \
+template <typename T> \
+void NAME(const Array<T>& arr, arg_type axis, Array<T>& out) { \
+    detail::scan_into(arr, axis, out, OP()); \
+} \
+template <typename T> \
+Array<T> NAME(const Array<T>& arr) { \
+    Array<T> res(Shape{arr.size()}, T()); \
+    detail::scan_into(arr, res, OP()); \
+    return res; \
+} \
+template <typename T> \
+Array<T> NAME(const Array<T>& arr, arg_type axis) { \
+    Array<T> res(arr.shape(), T()); \
+    detail::scan_into(arr, axis, res, OP()); \
+    return res; \
+}
+
+DEFINE_CUMULATIVE_FUNC(cumsum,  detail::ScanSum)
+DEFINE_CUMULATIVE_FUNC(cumprod, detail::ScanProd)
+DEFINE_CUMULATIVE_FUNC(cummin,  detail::ScanMin)
+DEFINE_CUMULATIVE_FUNC(cummax,  detail::ScanMax)
+
+#undef DEFINE_CUMULATIVE_FUNC
+
+// ----------------- Difference -----------------
+
+template <typename T>
+Array<T>
+diff(const Array<T>& arr, arg_type n, arg_type axis)
+{
+    if (n < 0) throw std::invalid_argument("diff::Order must be non-negative");
+    arg_type outer, len, inner;
+    detail::split_axis(arr.shape(), axis, outer, len, inner);
+
+    Array<T> cur(arr);
+    for (arg_type step = 0; step < n && len > 0; ++step) {
+        Shape shape = cur.shape();
+        shape[axis] = len - 1;
+        Array<T> next(shape, T());
+        const T* s = cur.data();
+        T* d = next.data();
+        const arg_type new_len = len - 1;
+        Parallel::parallel_for(0, outer * new_len, [&](arg_type b, arg_type e) {
+            for (arg_type r = b; r < e; ++r) {
+                const arg_type o = r / new_len, k = r % new_len;
+                const T* lo = s + (o * len + k) * inner;
+                const T* hi = lo + inner;
+                T* out = d + r * inner;
+                for (arg_type j = 0; j < inner; ++j) out[j] = hi[j] - lo[j];
+            }
+        }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / std::max<arg_type>(1, inner)));
+        cur = std::move(next);
+        len = new_len;
+    }
+    return cur;
+}
+
+}
@@ -0,0 +1,493 @@
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace SamH::NumC::FFT
+{
+
+namespace detail
+{
+    // Lengths whose largest prime factor exceeds this go through Bluestein
+    constexpr arg_type MAX_DIRECT_RADIX = 13;
+
+    inline complex twiddle(arg_type k, arg_type n)
+    {
+        const double phase = -2.0 * PI * static_cast<double>(k) / static_cast<double>(n);
+        return complex(std::cos(phase), std::sin(phase));
+    }
+
+    // (radix, remaining length) pairs, radix 4 first, then 2, then odd primes
+    inline std::vector<arg_type> factorize(arg_type n, arg_type& largest)
+    {
+        std::vector<arg_type> factors;
+        largest = 1;
+        arg_type p = 4;
+        while (n > 1) {
+            while (n % p != 0) {
+                switch (p) {
+                    case 4:  p = 2; break;
+                    case 2:  p = 3; break;
+                    default: p += 2; break;
+                }
+                if (p * p > n) p = n;
+            }
+            n /= p;
+            largest = std::max(largest, p);
+            factors.push_back(p);
+            factors.push_back(n);
+        }
+        return factors;
+    }
+
+    template <typename Cache, typename Make>
+    auto cached(Cache& cache, std::mutex& mutex, arg_type n, Make make)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = cache.find(n);
+            if (it != cache.end()) return it->second;
+        }
+        auto plan = make();
+        std::lock_guard<std::mutex> lock(mutex);
+        return cache.emplace(n, plan).first->second;
+    }
+
+    // Axis counted from the back when negative, checked against the array's dimensions
+    inline arg_type lane_axis(const Shape& shape, arg_type axis)
+    {
+        const arg_type ndim = shape.size();
+        if (ndim == 0) throw std::invalid_argument("FFT::Array has no dimensions");
+        if (axis < 0) axis += ndim;
+        if (axis < 0 || axis >= ndim) throw std::out_of_range("FFT::Axis out of range");
+        return axis;
+    }
+
+    // Applies lane_op(in, out) to every 1-D lane along `axis`. in_len values are
+    // gathered per lane and out_len values are scattered back into the result.
+    template <typename In, typename Out, typename LaneOp>
+    Array<Out> transform_lanes(const Array<In>& arr, arg_type axis, arg_type out_len, LaneOp lane_op)
+    {
+        const Shape& shape = arr.shape();
+        const arg_type ndim = shape.size();
+        axis = lane_axis(shape, axis);
+
+        arg_type outer = 1, inner = 1;
+        for (arg_type i = 0; i < axis; ++i) outer *= shape[i];
+        for (arg_type i = axis + 1; i < ndim; ++i) inner *= shape[i];
+        const arg_type in_len = shape[axis];
+
+        Shape out_shape = shape;
+        out_shape[axis] = out_len;
+        Array<Out> res(out_shape, Out());
+        if (in_len == 0 || out_len == 0) return res;
+
+        const In* src = arr.data();
+        Out* dst = res.data();
+        const arg_type lanes = outer * inner;
+        const arg_type grain = std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / std::max(in_len, out_len));
+
+        Parallel::parallel_for(0, lanes, [&](arg_type b, arg_type e) {
+            std::vector<In> buf_in(inner == 1 ? 0 : in_len);
+            std::vector<Out> buf_out(inner == 1 ? 0 : out_len);
+            for (arg_type lane = b; lane < e; ++lane) {
+                const arg_type o = lane / inner, j = lane % inner;
+                const In* lane_in = src + o * in_len * inner + j;
+                Out* lane_out = dst + o * out_len * inner + j;
+                if (inner == 1) {
+                    lane_op(lane_in, lane_out);
+                    continue;
+                }
+                for (arg_type k = 0; k < in_len; ++k) buf_in[k] = lane_in[k * inner];
+                lane_op(buf_in.data(), buf_out.data());
+                for (arg_type k = 0; k < out_len; ++k) lane_out[k * inner] = buf_out[k];
+            }
+        }, grain);
+        return res;
+    }
+
+    inline Array<complex> complex_transform(const Array<complex>& arr, arg_type axis, bool inverse)
+    {
+        axis = lane_axis(arr.shape(), axis);
+        const arg_type n = arr.shape()[axis];
+        if (n == 0) return arr;
+        const auto plan = Plan::get(n);
+        const double scale = inverse ? 1.0 / n : 1.0;
+        return transform_lanes<complex, complex>(arr, axis, n, [&](const complex* in, complex* out) {
+            plan->execute(in, out, inverse);
+            if (inverse) for (arg_type k = 0; k < n; ++k) out[k] *= scale;
+        });
+    }
+}
+
+// ----------------- PLAN -----------------
+
+inline Plan::Plan(arg_type n)
+    : p_n(n)
+    , p_bluestein(false)
+{
+    if (n <= 0) throw std::invalid_argument("FFT::Length must be positive");
+
+    arg_type largest;
+    p_factors = detail::factorize(n, largest);
+
+    if (largest > detail::MAX_DIRECT_RADIX) {
+        // Chirp-z: X[k] = w[k] * sum_j (x[j] w[j]) conj(w[k - j]) with w[k] = e^{-i pi k^2 / n},
+        // evaluated as a circular convolution of power-of-two length
+        p_bluestein = true;
+        arg_type m = 1;
+        while (m < 2 * n - 1) m <<= 1;
+        p_inner = Plan::get(m);
+
+        p_chirp.resize(n);
+        for (arg_type k = 0; k < n; ++k) {
+            const arg_type k2 = (k * k) % (2 * n);   // keeps the phase argument small
+            const double phase = -PI * static_cast<double>(k2) / static_cast<double>(n);
+            p_chirp[k] = complex(std::cos(phase), std::sin(phase));
+        }
+
+        std::vector<complex> b(m, complex(0.0, 0.0));
+        b[0] = std::conj(p_chirp[0]);
+        for (arg_type k = 1; k < n; ++k) b[k] = b[m - k] = std::conj(p_chirp[k]);
+        p_chirp_fft.resize(m);
+        p_inner->execute(b.data(), p_chirp_fft.data(), false);
+        return;
+    }
+
+    p_twiddles.resize(n);
+    p_itwiddles.resize(n);
+    for (arg_type k = 0; k < n; ++k) {
+        p_twiddles[k] = detail::twiddle(k, n);
+        p_itwiddles[k] = std::conj(p_twiddles[k]);
+    }
+}
+
+inline std::shared_ptr<const Plan>
+Plan::get(arg_type n)
+{
+    static std::unordered_map<arg_type, std::shared_ptr<const Plan>> cache;
+    static std::mutex mutex;
+    return detail::cached(cache, mutex, n, [n] { return std::make_shared<const Plan>(n); });
+}
+
+inline arg_type
+Plan::size() const
+{
+    return p_n;
+}
+
+inline void
+Plan::execute(const complex* in, complex* out, bool inverse) const
+{
+    if (p_bluestein) {
+        if (!inverse) {
+            bluestein(in, out);
+            return;
+        }
+        // Inverse through the forward transform: ifft(x) = conj(fft(conj(x)))
+        std::vector<complex> tmp(in, in + p_n);
+        for (auto& v : tmp) v = std::conj(v);
+        bluestein(tmp.data(), out);
+        for (arg_type k = 0; k < p_n; ++k) out[k] = std::conj(out[k]);
+        return;
+    }
+
+    if (p_n == 1) {
+        out[0] = in[0];
+    } else if (in == out) {
+        std::vector<complex> tmp(in, in + p_n);
+        work(out, tmp.data(), 1, 1, p_factors.data(), inverse);
+    } else {
+        work(out, in, 1, 1, p_factors.data(), inverse);
+    }
+}
+
+inline void
+Plan::bluestein(const complex* in, complex* out) const
+{
+    const arg_type m = p_inner->size();
+    std::vector<complex> a(m, complex(0.0, 0.0));
+    for (arg_type k = 0; k < p_n; ++k) a[k] = in[k] * p_chirp[k];
+
+    p_inner->execute(a.data(), a.data(), false);
+    for (arg_type k = 0; k < m; ++k) a[k] *= p_chirp_fft[k];
+    p_inner->execute(a.data(), a.data(), true);
+
+    const double scale = 1.0 / m;
+    for (arg_type k = 0; k < p_n; ++k) out[k] = a[k] * p_chirp[k] * scale;
+}
+
+// Recursive decimation in time: split into `p` interleaved sub-sequences of length m,
+// transform them, then combine with a radix-p butterfly
+inline void
+Plan::work(complex* out, const complex* in, arg_type fstride, arg_type in_stride,
+           const arg_type* factors, bool inverse) const
+{
+    const arg_type p = factors[0];
+    const arg_type m = factors[1];
+    complex* const out_begin = out;
+    const complex* const out_end = out + p * m;
+
+    if (m == 1) {
+        do {
+            *out = *in;
+            in += fstride * in_stride;
+        } while (++out != out_end);
+    } else {
+        do {
+            work(out, in, fstride * p, in_stride, factors + 2, inverse);
+            in += fstride * in_stride;
+        } while ((out += m) != out_end);
+    }
+
+    out = out_begin;
+    switch (p) {
+        case 2:  butterfly2(out, fstride, m, inverse); break;
+        case 3:  butterfly3(out, fstride, m, inverse); break;
+        case 4:  butterfly4(out, fstride, m, inverse); break;
+        default: butterfly_generic(out, fstride, m, p, inverse); break;
+    }
+}
+
+inline void
+Plan::butterfly2(complex* out, arg_type fstride, arg_type m, bool inverse) const
+{
+    const complex* tw = inverse ? p_itwiddles.data() : p_twiddles.data();
+    complex* out2 = out + m;
+    for (arg_type k = 0; k < m; ++k) {
+        const complex t = out2[k] * tw[k * fstride];
+        out2[k] = out[k] - t;
+        out[k] += t;
+    }
+}
+
+inline void
+Plan::butterfly3(complex* out, arg_type fstride, arg_type m, bool inverse) const
+{
+    const complex* tw = inverse ? p_itwiddles.data() : p_twiddles.data();
+    const double epi3 = tw[fstride * m].imag();
+    for (arg_type k = 0; k < m; ++k) {
+        const complex s1 = out[k + m] * tw[k * fstride];
+        const complex s2 = out[k + 2 * m] * tw[2 * k * fstride];
+        const complex s3 = s1 + s2;
+        const complex s0 = (s1 - s2) * epi3;
+
+        const complex mid = out[k] - s3 * 0.5;
+        out[k] += s3;
+        out[k + 2 * m] = complex(mid.real() + s0.imag(), mid.imag() - s0.real());
+        out[k + m]     = complex(mid.real() - s0.imag(), mid.imag() + s0.real());
+    }
+}
+
+inline void
+Plan::butterfly4(complex* out, arg_type fstride, arg_type m, bool inverse) const
+{
+    const complex* tw = inverse ? p_itwiddles.data() : p_twiddles.data();
+    for (arg_type k = 0; k < m; ++k) {
+        const complex s0 = out[k + m]     * tw[k * fstride];
+        const complex s1 = out[k + 2 * m] * tw[2 * k * fstride];
+        const complex s2 = out[k + 3 * m] * tw[3 * k * fstride];
+
+        const complex s5 = out[k] - s1;
+        out[k] += s1;
+        const complex s3 = s0 + s2;
+        const complex s4 = s0 - s2;
+        out[k + 2 * m] = out[k] - s3;
+        out[k] += s3;
+
+        if (inverse) {
+            out[k + m]     = complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+            out[k + 3 * m] = complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+        } else {
+            out[k + m]     = complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+            out[k + 3 * m] = complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+        }
+    }
+}
+
+inline void
+Plan::butterfly_generic(complex* out, arg_type fstride, arg_type m, arg_type p, bool inverse) const
+{
+    const complex* tw = inverse ? p_itwiddles.data() : p_twiddles.data();
+    std::vector<complex> scratch(p);
+    for (arg_type u = 0; u < m; ++u) {
+        for (arg_type q = 0, k = u; q < p; ++q, k += m) scratch[q] = out[k];
+
+        for (arg_type q1 = 0, k = u; q1 < p; ++q1, k += m) {
+            arg_type twidx = 0;
+            complex acc = scratch[0];
+            for (arg_type q = 1; q < p; ++q) {
+                twidx += fstride * k;
+                if (twidx >= p_n) twidx -= p_n;
+                acc += scratch[q] * tw[twidx];
+            }
+            out[k] = acc;
+        }
+    }
+}
+
+// ----------------- REAL PLAN -----------------
+
+inline RealPlan::RealPlan(arg_type n)
+    : r_n(n)
+{
+    if (n <= 0 || n % 2 != 0) throw std::invalid_argument("FFT::RealPlan requires an even length");
+    r_half = Plan::get(n / 2);
+    r_twiddles.resize(n / 2 + 1);
+    for (arg_type k = 0; k <= n / 2; ++k) r_twiddles[k] = detail::twiddle(k, n);
+}
+
+inline std::shared_ptr<const RealPlan>
+RealPlan::get(arg_type n)
+{
+    static std::unordered_map<arg_type, std::shared_ptr<const RealPlan>> cache;
+    static std::mutex mutex;
+    return detail::cached(cache, mutex, n, [n] { return std::make_shared<const RealPlan>(n); });
+}
+
+inline arg_type
+RealPlan::size() const
+{
+    return r_n;
+}
+
+// Even and odd samples are packed as z = x_even + i x_odd; one half-length transform
+// gives both spectra, which are untangled with the conjugate-symmetric split
+inline void
+RealPlan::forward(const double* in, complex* out) const
+{
+    const arg_type h = r_n / 2;
+    std::vector<complex> z(h);
+    for (arg_type k = 0; k < h; ++k) z[k] = complex(in[2 * k], in[2 * k + 1]);
+    r_half->execute(z.data(), z.data(), false);
+
+    for (arg_type k = 0; k <= h; ++k) {
+        const complex zk  = z[k % h];
+        const complex znk = std::conj(z[(h - k) % h]);
+        const complex even = (zk + znk) * 0.5;
+        const complex odd  = (zk - znk) * complex(0.0, -0.5);
+        out[k] = even + r_twiddles[k] * odd;
+    }
+}
+
+inline void
+RealPlan::inverse(const complex* in, double* out) const
+{
+    const arg_type h = r_n / 2;
+    std::vector<complex> z(h);
+    for (arg_type k = 0; k < h; ++k) {
+        const complex xk  = in[k];
+        const complex xnk = std::conj(in[h - k]);
+        const complex even = (xk + xnk) * 0.5;
+        const complex odd  = (xk - xnk) * 0.5 * std::conj(r_twiddles[k]);
+        z[k] = even + complex(0.0, 1.0) * odd;
+    }
+    r_half->execute(z.data(), z.data(), true);
+
+    const double scale = 1.0 / h;
+    for (arg_type k = 0; k < h; ++k) {
+        out[2 * k]     = z[k].real() * scale;
+        out[2 * k + 1] = z[k].imag() * scale;
+    }
+}
+
+// ----------------- TRANSFORMS -----------------
+
+inline Array<complex>
+fft(const Array<complex>& arr, arg_type axis)
+{
+    return detail::complex_transform(arr, axis, false);
+}
+
+inline Array<complex>
+ifft(const Array<complex>& arr, arg_type axis)
+{
+    return detail::complex_transform(arr, axis, true);
+}
+
+template <typename T>
+Array<complex>
+fft(const Array<T>& arr, arg_type axis)
+{
+    Array<complex> tmp(arr.shape(), complex());
+    for (arg_type i = 0; i < arr.size(); ++i) tmp[i] = complex(static_cast<double>(arr[i]), 0.0);
+    return fft(tmp, axis);
+}
+
+template <typename T>
+Array<complex>
+rfft(const Array<T>& arr)
+{
+    if (arr.shape().empty()) throw std::invalid_argument("FFT::Array has no dimensions");
+    const arg_type n = arr.shape().back();
+    if (n == 0) return Array<complex>(arr.shape(), complex());
+
+    if (n % 2 != 0) {
+        // Odd lengths do not pack into a half-length transform
+        const Array<complex> full = fft(arr, -1);
+        return detail::transform_lanes<complex, complex>(full, -1, n / 2 + 1,
+            [&](const complex* in, complex* out) { std::copy(in, in + n / 2 + 1, out); });
+    }
+
+    const auto plan = RealPlan::get(n);
+    return detail::transform_lanes<T, complex>(arr, -1, n / 2 + 1, [&](const T* in, complex* out) {
+        if constexpr (std::is_same_v<T, double>) {
+            plan->forward(in, out);
+        } else {
+            std::vector<double> tmp(in, in + n);
+            plan->forward(tmp.data(), out);
+        }
+    });
+}
+
+inline Array<double>
+irfft(const Array<complex>& arr, arg_type n)
+{
+    if (arr.shape().empty()) throw std::invalid_argument("FFT::Array has no dimensions");
+    const arg_type m = arr.shape().back();
+    if (n < 0) n = 2 * (m - 1);
+    if (n <= 0) throw std::invalid_argument("FFT::Invalid output length");
+
+    if (n % 2 == 0 && m >= n / 2 + 1) {
+        const auto plan = RealPlan::get(n);
+        return detail::transform_lanes<complex, double>(arr, -1, n, [&](const complex* in, double* out) {
+            plan->inverse(in, out);
+        });
+    }
+
+    // Rebuild the full Hermitian spectrum and use the complex transform
+    const auto plan = Plan::get(n);
+    return detail::transform_lanes<complex, double>(arr, -1, n, [&](const complex* in, double* out) {
+        std::vector<complex> full(n, complex(0.0, 0.0));
+        for (arg_type k = 0; k < std::min(m, n / 2 + 1); ++k) {
+            full[k] = in[k];
+            if (k > 0) full[n - k] = std::conj(in[k]);
+        }
+        plan->execute(full.data(), full.data(), true);
+        for (arg_type k = 0; k < n; ++k) out[k] = full[k].real() / n;
+    });
+}
+
+inline Array<complex>
+fft2(const Array<complex>& arr)
+{
+    if (arr.shape().size() < 2) throw std::invalid_argument("FFT::fft2 requires at least 2 dimensions");
+    return fft(fft(arr, -1), -2);
+}
+
+inline Array<complex>
+ifft2(const Array<complex>& arr)
+{
+    if (arr.shape().size() < 2) throw std::invalid_argument("FFT::ifft2 requires at least 2 dimensions");
+    return ifft(ifft(arr, -1), -2);
+}
+
+template <typename T>
+Array<complex>
+fft2(const Array<T>& arr)
+{
+    if (arr.shape().size() < 2) throw std::invalid_argument("FFT::fft2 requires at least 2 dimensions");
+    return fft(fft(arr, -1), -2);
+}
+
+}
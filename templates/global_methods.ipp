@@ -446,7 +446,21 @@ Array<T> concatenate(const Array<T>& arr1, const Array<T>& arr2, arg_type axis)
 
 template <typename T>
 Array<T>
-zeros(const std::vector<arg_type>& dims)
+empty(const Shape& dims)
+{
+    return Array<T>::uninitialized(dims);
+}
+
+template <typename T>
+Array<T>
+empty_like(const Array<T>& arr)
+{
+    return Array<T>::uninitialized(arr.shape());
+}
+
+template <typename T>
+Array<T>
+zeros(const Shape& dims)
 {
     return Array<T>(dims, T(0));
 }
@@ -460,7 +474,7 @@ zeros_like(const Array<T>& arr)
 
 template <typename T>
 Array<T>
-ones(const std::vector<arg_type>& dims)
+ones(const Shape& dims)
 {
     return Array<T>(dims, T(1));
 }
@@ -0,0 +1,555 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace SamH::NumC::Global
+{
+
+namespace detail
+{
+    // Largest key range, relative to the input size, aggregated by direct indexing
+    constexpr arg_type GROUP_DENSE_SLACK = arg_type(1) << 16;
+    // Rows hashed and prefetched ahead of their table lookups
+    constexpr arg_type GROUP_BATCH = 16;
+
+    inline std::uint64_t mix64(std::uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Bits that equal keys share: -0.0 hashes as 0.0 and every NaN alike
+    template <typename K>
+    std::uint64_t key_bits(K value)
+    {
+        if constexpr (std::is_floating_point_v<K>) {
+            if (value != value) return 0x7ff8000000000000ULL;
+            if (value == 0) return 0;
+            const double wide = static_cast<double>(value);
+            std::uint64_t bits;
+            std::memcpy(&bits, &wide, sizeof(bits));
+            return bits;
+        } else {
+            return static_cast<std::uint64_t>(value);
+        }
+    }
+
+    template <typename K>
+    bool key_equal(K a, K b)
+    {
+        if constexpr (std::is_floating_point_v<K>) return a == b || (a != a && b != b);
+        else                                       return a == b;
+    }
+
+    template <typename K>
+    std::uint64_t hash_key(const K* key, arg_type width)
+    {
+        std::uint64_t h = 0;
+        for (arg_type c = 0; c < width; ++c) h = mix64(h * 0x9E3779B97F4A7C15ULL + key_bits(key[c]));
+        return h;
+    }
+
+    // Lexicographic, NaN after every number
+    template <typename K>
+    bool key_less(const K* a, const K* b, arg_type width)
+    {
+        for (arg_type c = 0; c < width; ++c) {
+            if (key_equal(a[c], b[c])) continue;
+            if constexpr (std::is_floating_point_v<K>) {
+                if (a[c] != a[c]) return false;
+                if (b[c] != b[c]) return true;
+            }
+            return a[c] < b[c];
+        }
+        return false;
+    }
+
+    // ----------------- KEY TABLE -----------------
+    template <typename K>
+    KeyTable<K>::KeyTable(arg_type width, arg_type expected)
+        : k_exact(width == 1 && sizeof(K) <= sizeof(std::uint64_t) && !std::is_same_v<K, long double>)
+        , k_width(width)
+    {
+        rehash(16);
+        reserve(expected);
+    }
+
+    template <typename K>
+    void
+    KeyTable<K>::reserve(arg_type count)
+    {
+        std::size_t capacity = k_slots.size();
+        while (static_cast<std::size_t>(count) * 2 > capacity) capacity *= 2;
+        if (capacity != k_slots.size()) rehash(capacity);
+        k_keys.reserve(count * k_width);
+        k_hashes.reserve(count);
+    }
+
+    template <typename K>
+    bool
+    KeyTable<K>::same(const Slot& slot, const K* key, std::uint64_t hash) const
+    {
+        if (slot.hash != hash) return false;
+        if (k_exact) return true;
+        const K* other = this->key(slot.id);
+        for (arg_type c = 0; c < k_width; ++c) {
+            if (!key_equal(other[c], key[c])) return false;
+        }
+        return true;
+    }
+
+    template <typename K>
+    void
+    KeyTable<K>::prefetch(std::uint64_t hash) const
+    {
+        __builtin_prefetch(k_slots.data() + (hash & k_mask));
+    }
+
+    template <typename K>
+    void
+    KeyTable<K>::rehash(std::size_t capacity)
+    {
+        k_slots.assign(capacity, Slot{0, -1});
+        k_mask = capacity - 1;
+        for (arg_type id = 0; id < size(); ++id) {
+            std::size_t index = k_hashes[id] & k_mask;
+            while (k_slots[index].id >= 0) index = (index + 1) & k_mask;
+            k_slots[index] = Slot{k_hashes[id], id};
+        }
+    }
+
+    template <typename K>
+    arg_type
+    KeyTable<K>::insert(const K* key, std::uint64_t hash, bool& inserted)
+    {
+        if (static_cast<std::size_t>(size() + 1) * 2 > k_slots.size()) rehash(k_slots.size() * 2);
+        std::size_t index = hash & k_mask;
+        for (;;) {
+            Slot& slot = k_slots[index];
+            if (slot.id < 0) {
+                slot = Slot{hash, size()};
+                k_keys.insert(k_keys.end(), key, key + k_width);
+                k_hashes.push_back(hash);
+                inserted = true;
+                return slot.id;
+            }
+            if (same(slot, key, hash)) {
+                inserted = false;
+                return slot.id;
+            }
+            index = (index + 1) & k_mask;
+        }
+    }
+
+    template <typename K>
+    arg_type
+    KeyTable<K>::find(const K* key, std::uint64_t hash) const
+    {
+        std::size_t index = hash & k_mask;
+        for (;;) {
+            const Slot& slot = k_slots[index];
+            if (slot.id < 0) return -1;
+            if (same(slot, key, hash)) return slot.id;
+            index = (index + 1) & k_mask;
+        }
+    }
+
+    // ----------------- AGGREGATION -----------------
+    // Key rows of the input, one pointer per key column
+    template <typename K>
+    struct KeyColumns
+    {
+        std::vector<const K*> columns;
+        arg_type rows = 0;
+
+        arg_type width() const { return static_cast<arg_type>(columns.size()); }
+
+        // Row i, in place for a single column or copied into buffer
+        const K* row(arg_type i, K* buffer) const
+        {
+            if (columns.size() == 1) return columns[0] + i;
+            for (std::size_t c = 0; c < columns.size(); ++c) buffer[c] = columns[c][i];
+            return buffer;
+        }
+    };
+
+    template <typename K>
+    KeyColumns<K> key_columns(const Array<K>& keys)
+    {
+        return KeyColumns<K>{ {keys.data()}, keys.size() };
+    }
+
+    template <typename K>
+    KeyColumns<K> key_columns(const std::vector<Array<K>>& keys)
+    {
+        if (keys.empty()) throw std::invalid_argument("group_by::At least one key column is required");
+        KeyColumns<K> res;
+        res.rows = keys[0].size();
+        for (const auto& column : keys) {
+            if (column.size() != res.rows) {
+                throw std::invalid_argument("group_by::Key columns must have the same size");
+            }
+            res.columns.push_back(column.data());
+        }
+        return res;
+    }
+
+    // State folded with op and the number of values seen, side by side so an update
+    // touches one cache line
+    template <typename S>
+    struct GroupState
+    {
+        S state;
+        arg_type count;
+    };
+
+    template <typename K, typename S>
+    struct GroupPartial
+    {
+        KeyTable<K> table;
+        std::vector<GroupState<S>> groups;
+
+        explicit GroupPartial(arg_type width) : table(width) {}
+
+        // Group of the key, -1 when the key is new and already holds value
+        arg_type find_or_add(const K* key, std::uint64_t hash, const S& value, arg_type count)
+        {
+            bool inserted;
+            const arg_type g = table.insert(key, hash, inserted);
+            if (!inserted) return g;
+            groups.push_back(GroupState<S>{value, count});
+            return -1;
+        }
+
+        template <typename Op>
+        void fold(arg_type g, const S& value, arg_type count, Op op)
+        {
+            groups[g].state = op(groups[g].state, value);
+            groups[g].count += count;
+        }
+
+        template <typename Op>
+        void add(const K* key, std::uint64_t hash, const S& value, arg_type count, Op op)
+        {
+            const arg_type g = find_or_add(key, hash, value, count);
+            if (g >= 0) fold(g, value, count, op);
+        }
+    };
+
+    template <typename R, typename K, typename S, typename Finish>
+    void write_group(Grouped<K, R>& res, arg_type out, const K* key, arg_type width,
+                     const S& state, arg_type count, Finish finish)
+    {
+        K* dst = res.keys.data() + out * width;
+        for (arg_type c = 0; c < width; ++c) {
+            if constexpr (std::is_floating_point_v<K>) dst[c] = key[c] == 0 ? K(0) : key[c];
+            else                                       dst[c] = key[c];
+        }
+        res.values.data()[out] = finish(state, count);
+    }
+
+    template <typename K, typename R>
+    Grouped<K, R> make_grouped(arg_type groups, arg_type width)
+    {
+        Shape key_shape{groups};
+        if (width > 1) key_shape.push_back(width);
+        return Grouped<K, R>{ Array<K>::uninitialized(key_shape), Array<R>::uninitialized(Shape{groups}) };
+    }
+
+    // Small-range integer keys: every thread folds into private arrays indexed by
+    // key - low, which are then combined and compacted in key order
+    template <typename R, typename K, typename S, typename ValueOf, typename Op, typename Finish>
+    Grouped<K, R> group_dense(const K* keys, arg_type n, K low, arg_type range,
+                              ValueOf value_of, Op op, Finish finish)
+    {
+        arg_type chunks = Parallel::chunk_count(n);
+        chunks = std::max<arg_type>(1, std::min(chunks, (2 * n + GROUP_DENSE_SLACK) / range));
+
+        std::vector<std::vector<S>> states(chunks);
+        std::vector<std::vector<arg_type>> counts(chunks);
+        Parallel::parallel_chunks(0, n, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+            std::vector<S>& state = states[chunk];
+            std::vector<arg_type>& count = counts[chunk];
+            state.assign(range, S());
+            count.assign(range, 0);
+            for (arg_type i = b; i < e; ++i) {
+                const arg_type slot = static_cast<arg_type>(keys[i] - low);
+                const S value = value_of(i);
+                state[slot] = count[slot]++ == 0 ? value : op(state[slot], value);
+            }
+        });
+
+        for (arg_type c = 1; c < chunks; ++c) {
+            Parallel::parallel_for(0, range, [&](arg_type b, arg_type e) {
+                for (arg_type slot = b; slot < e; ++slot) {
+                    if (counts[c][slot] == 0) continue;
+                    states[0][slot] = counts[0][slot] == 0 ? states[c][slot] : op(states[0][slot], states[c][slot]);
+                    counts[0][slot] += counts[c][slot];
+                }
+            });
+        }
+
+        const std::vector<arg_type>& count = counts[0];
+        const arg_type groups = range - std::count(count.begin(), count.end(), arg_type(0));
+        Grouped<K, R> res = make_grouped<K, R>(groups, 1);
+        arg_type out = 0;
+        for (arg_type slot = 0; slot < range; ++slot) {
+            if (count[slot] == 0) continue;
+            const K key = static_cast<K>(low + slot);
+            write_group(res, out++, &key, 1, states[0][slot], count[slot], finish);
+        }
+        return res;
+    }
+
+    // Key range when it is small enough to index directly, 0 otherwise
+    template <typename K>
+    arg_type dense_range(const K* keys, arg_type n, K& low)
+    {
+        if constexpr (std::is_integral_v<K>) {
+            const arg_type chunks = Parallel::chunk_count(n);
+            std::vector<K> lows(std::max<arg_type>(1, chunks), keys[0]);
+            std::vector<K> highs(std::max<arg_type>(1, chunks), keys[0]);
+            Parallel::parallel_chunks(0, n, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+                const auto [lo, hi] = std::minmax_element(keys + b, keys + e);
+                lows[chunk] = *lo;
+                highs[chunk] = *hi;
+            });
+            low = *std::min_element(lows.begin(), lows.end());
+            const K high = *std::max_element(highs.begin(), highs.end());
+            const std::uint64_t span = static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low);
+            if (span < static_cast<std::uint64_t>(2 * n + GROUP_DENSE_SLACK)) return static_cast<arg_type>(span) + 1;
+        }
+        return 0;
+    }
+
+    // value_of(i) gives row i's contribution, op folds two states of one group and
+    // finish(state, count) produces the result. Groups come out sorted by key.
+    template <typename R, typename K, typename S, typename ValueOf, typename Op, typename Finish>
+    Grouped<K, R> group_aggregate(const KeyColumns<K>& keys, ValueOf value_of, Op op, Finish finish)
+    {
+        const arg_type n = keys.rows;
+        const arg_type width = keys.width();
+        if (n == 0) return make_grouped<K, R>(0, width);
+
+        if (width == 1) {
+            K low;
+            const arg_type range = dense_range(keys.columns[0], n, low);
+            if (range > 0) return group_dense<R, K, S>(keys.columns[0], n, low, range, value_of, op, finish);
+        }
+
+        // Private tables, one per chunk of rows
+        const arg_type chunks = Parallel::chunk_count(n);
+        std::vector<GroupPartial<K, S>> partials(chunks, GroupPartial<K, S>(width));
+        Parallel::parallel_chunks(0, n, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+            GroupPartial<K, S>& partial = partials[chunk];
+            std::vector<K> buffer(width);
+            std::uint64_t hashes[GROUP_BATCH];
+            arg_type ids[GROUP_BATCH];
+            for (arg_type i = b; i < e; i += GROUP_BATCH) {
+                // Hash the batch and prefetch its slots, resolve the groups and prefetch
+                // their states, then fold
+                const arg_type m = std::min(GROUP_BATCH, e - i);
+                for (arg_type j = 0; j < m; ++j) {
+                    hashes[j] = hash_key(keys.row(i + j, buffer.data()), width);
+                    partial.table.prefetch(hashes[j]);
+                }
+                for (arg_type j = 0; j < m; ++j) {
+                    ids[j] = partial.find_or_add(keys.row(i + j, buffer.data()), hashes[j], value_of(i + j), 1);
+                    if (ids[j] >= 0) __builtin_prefetch(partial.groups.data() + ids[j]);
+                }
+                for (arg_type j = 0; j < m; ++j) {
+                    if (ids[j] >= 0) partial.fold(ids[j], value_of(i + j), 1, op);
+                }
+            }
+        });
+
+        // Merge by the hash's high bits: partition p gathers its groups from every
+        // private table, so partitions merge independently
+        const arg_type parts = chunks == 1 ? 1 : chunks * 2;
+        auto part_of = [parts](std::uint64_t hash) {
+            return static_cast<arg_type>(((hash >> 32) * static_cast<std::uint64_t>(parts)) >> 32);
+        };
+        std::vector<std::vector<arg_type>> order(chunks), offsets(chunks);
+        Parallel::parallel_for(0, chunks, [&](arg_type b, arg_type e) {
+            for (arg_type c = b; c < e; ++c) {
+                const KeyTable<K>& table = partials[c].table;
+                offsets[c].assign(parts + 1, 0);
+                for (arg_type g = 0; g < table.size(); ++g) ++offsets[c][part_of(table.hash(g)) + 1];
+                std::partial_sum(offsets[c].begin(), offsets[c].end(), offsets[c].begin());
+                order[c].resize(table.size());
+                std::vector<arg_type> next(offsets[c].begin(), offsets[c].end() - 1);
+                for (arg_type g = 0; g < table.size(); ++g) order[c][next[part_of(table.hash(g))]++] = g;
+            }
+        }, 1);
+
+        std::vector<GroupPartial<K, S>> merged(parts, GroupPartial<K, S>(width));
+        Parallel::parallel_for(0, parts, [&](arg_type b, arg_type e) {
+            for (arg_type p = b; p < e; ++p) {
+                GroupPartial<K, S>& target = merged[p];
+                for (arg_type c = 0; c < chunks; ++c) {
+                    const GroupPartial<K, S>& source = partials[c];
+                    for (arg_type j = offsets[c][p]; j < offsets[c][p + 1]; ++j) {
+                        const arg_type g = order[c][j];
+                        target.add(source.table.key(g), source.table.hash(g), source.groups[g].state,
+                                   source.groups[g].count, op);
+                    }
+                }
+            }
+        }, 1);
+        partials.clear();
+
+        // Every group sorted by key. The first key column is copied next to the group's
+        // location, so the sort only follows the location on ties.
+        struct GroupRef
+        {
+            K first;
+            arg_type part;
+            arg_type id;
+        };
+        std::vector<GroupRef> groups;
+        for (arg_type p = 0; p < parts; ++p) {
+            for (arg_type g = 0; g < merged[p].table.size(); ++g) groups.push_back(GroupRef{*merged[p].table.key(g), p, g});
+        }
+        std::sort(groups.begin(), groups.end(), [&](const GroupRef& a, const GroupRef& b) {
+            if (!key_equal(a.first, b.first)) return key_less(&a.first, &b.first, 1);
+            return width > 1 && key_less(merged[a.part].table.key(a.id) + 1, merged[b.part].table.key(b.id) + 1, width - 1);
+        });
+
+        const arg_type count = static_cast<arg_type>(groups.size());
+        Grouped<K, R> res = make_grouped<K, R>(count, width);
+        Parallel::parallel_for(0, count, [&](arg_type b, arg_type e) {
+            for (arg_type i = b; i < e; ++i) {
+                const GroupPartial<K, S>& part = merged[groups[i].part];
+                const arg_type g = groups[i].id;
+                write_group(res, i, part.table.key(g), width, part.groups[g].state, part.groups[g].count, finish);
+            }
+        });
+        return res;
+    }
+
+    template <typename K, typename V>
+    void check_group_values(const KeyColumns<K>& keys, const Array<V>& values)
+    {
+        if (keys.rows != values.size()) {
+            throw std::invalid_argument("group_by::Keys and values must have the same size");
+        }
+    }
+
+    template <typename K, typename V>
+    Grouped<K, V> group_sum(const KeyColumns<K>& keys, const Array<V>& values)
+    {
+        check_group_values(keys, values);
+        const V* v = values.data();
+        return group_aggregate<V, K, V>(keys, [v](arg_type i) { return v[i]; }, ScanSum(),
+                                        [](const V& sum, arg_type) { return sum; });
+    }
+
+    template <typename K, typename V>
+    Grouped<K, double> group_mean(const KeyColumns<K>& keys, const Array<V>& values)
+    {
+        check_group_values(keys, values);
+        const V* v = values.data();
+        return group_aggregate<double, K, double>(keys, [v](arg_type i) { return static_cast<double>(v[i]); },
+                                                  ScanSum(),
+                                                  [](double sum, arg_type count) { return sum / count; });
+    }
+
+    template <typename K, typename V, typename Op>
+    Grouped<K, V> group_extreme(const KeyColumns<K>& keys, const Array<V>& values, Op op)
+    {
+        check_group_values(keys, values);
+        const V* v = values.data();
+        return group_aggregate<V, K, V>(keys, [v](arg_type i) { return v[i]; }, op,
+                                        [](const V& value, arg_type) { return value; });
+    }
+
+    template <typename K>
+    Grouped<K, arg_type> group_count(const KeyColumns<K>& keys)
+    {
+        return group_aggregate<arg_type, K, arg_type>(keys, [](arg_type) { return arg_type(0); }, ScanSum(),
+                                                      [](arg_type, arg_type count) { return count; });
+    }
+}
+
+// ----------------- GROUP BY -----------------
+
+template <typename K, typename V>
+Grouped<K, V>
+group_sum(const Array<K>& keys, const Array<V>& values)
+{
+    return detail::group_sum(detail::key_columns(keys), values);
+}
+
+template <typename K, typename V>
+Grouped<K, double>
+group_mean(const Array<K>& keys, const Array<V>& values)
+{
+    return detail::group_mean(detail::key_columns(keys), values);
+}
+
+template <typename K, typename V>
+Grouped<K, V>
+group_min(const Array<K>& keys, const Array<V>& values)
+{
+    return detail::group_extreme(detail::key_columns(keys), values, detail::ScanMin());
+}
+
+template <typename K, typename V>
+Grouped<K, V>
+group_max(const Array<K>& keys, const Array<V>& values)
+{
+    return detail::group_extreme(detail::key_columns(keys), values, detail::ScanMax());
+}
+
+template <typename K>
+Grouped<K, arg_type>
+group_count(const Array<K>& keys)
+{
+    return detail::group_count(detail::key_columns(keys));
+}
+
+template <typename K, typename V>
+Grouped<K, V>
+group_sum(const std::vector<Array<K>>& keys, const Array<V>& values)
+{
+    return detail::group_sum(detail::key_columns(keys), values);
+}
+
+template <typename K, typename V>
+Grouped<K, double>
+group_mean(const std::vector<Array<K>>& keys, const Array<V>& values)
+{
+    return detail::group_mean(detail::key_columns(keys), values);
+}
+
+template <typename K, typename V>
+Grouped<K, V>
+group_min(const std::vector<Array<K>>& keys, const Array<V>& values)
+{
+    return detail::group_extreme(detail::key_columns(keys), values, detail::ScanMin());
+}
+
+template <typename K, typename V>
+Grouped<K, V>
+group_max(const std::vector<Array<K>>& keys, const Array<V>& values)
+{
+    return detail::group_extreme(detail::key_columns(keys), values, detail::ScanMax());
+}
+
+template <typename K>
+Grouped<K, arg_type>
+group_count(const std::vector<Array<K>>& keys)
+{
+    return detail::group_count(detail::key_columns(keys));
+}
+
+}
@@ -0,0 +1,262 @@
+namespace SamH::NumC
+{
+
+// ----------------- CONVERSIONS -----------------
+
+namespace detail
+{
+    inline std::uint16_t
+    float_to_half_bits(float value)
+    {
+#if defined(__F16C__)
+        return _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT);
+#else
+        std::uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+        const std::uint32_t sign = (f >> 16) & 0x8000;
+        f &= 0x7fffffff;
+
+        if (f >= 0x7f800000) {
+            // Infinity stays infinite, NaN stays a quiet NaN
+            return sign | 0x7c00 | (f > 0x7f800000 ? 0x200 : 0);
+        }
+        if (f >= 0x47800000) {
+            return sign | 0x7c00;
+        }
+        if (f < 0x38800000) {
+            // Below the smallest normal half: a subnormal in units of 2^-24
+            if (f < 0x33000000) return sign;
+            const std::uint32_t shift = 126 - (f >> 23);
+            const std::uint32_t mantissa = (f & 0x7fffff) | 0x800000;
+            std::uint32_t h = mantissa >> shift;
+            const std::uint32_t rem = mantissa & ((1u << shift) - 1);
+            const std::uint32_t halfway = 1u << (shift - 1);
+            if (rem > halfway || (rem == halfway && (h & 1))) ++h;
+            return sign | h;
+        }
+
+        // Rebias the exponent and round the dropped 13 mantissa bits to nearest even;
+        // a carry out of the mantissa correctly bumps the exponent (up to infinity)
+        std::uint32_t h = (f - 0x38000000) >> 13;
+        const std::uint32_t rem = f & 0x1fff;
+        if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) ++h;
+        return sign | h;
+#endif
+    }
+
+    inline float
+    half_bits_to_float(std::uint16_t bits)
+    {
+#if defined(__F16C__)
+        return _cvtsh_ss(bits);
+#else
+        const std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000) << 16;
+        std::uint32_t exponent = (bits >> 10) & 0x1f;
+        std::uint32_t mantissa = bits & 0x3ff;
+        std::uint32_t f;
+
+        if (exponent == 0x1f) {
+            f = sign | 0x7f800000 | (mantissa << 13);
+        } else if (exponent == 0) {
+            if (mantissa == 0) {
+                f = sign;
+            } else {
+                // Normalize the subnormal
+                exponent = 113;
+                while (!(mantissa & 0x400)) {
+                    mantissa <<= 1;
+                    --exponent;
+                }
+                f = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+            }
+        } else {
+            f = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+
+        float value;
+        std::memcpy(&value, &f, sizeof(value));
+        return value;
+#endif
+    }
+
+    inline std::uint16_t
+    float_to_bfloat_bits(float value)
+    {
+        std::uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+        if ((f & 0x7fffffff) > 0x7f800000) {
+            return static_cast<std::uint16_t>((f >> 16) | 0x40);
+        }
+        f += 0x7fff + ((f >> 16) & 1);
+        return static_cast<std::uint16_t>(f >> 16);
+    }
+
+    inline float
+    bfloat_bits_to_float(std::uint16_t bits)
+    {
+        const std::uint32_t f = static_cast<std::uint32_t>(bits) << 16;
+        float value;
+        std::memcpy(&value, &f, sizeof(value));
+        return value;
+    }
+
+    inline void
+    widen(const float16* src, float* dst, arg_type n)
+    {
+        arg_type i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+        }
+#endif
+        for (; i < n; ++i) dst[i] = src[i];
+    }
+
+    inline void
+    widen(const bfloat16* src, float* dst, arg_type n)
+    {
+        arg_type i = 0;
+#if defined(__SSE2__)
+        // Interleaving zeros below every 16-bit value shifts it into the upper half of a float
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),     _mm_unpacklo_epi16(zero, h));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(zero, h));
+        }
+#endif
+        for (; i < n; ++i) dst[i] = src[i];
+    }
+
+    inline void
+    narrow(const float* src, float16* dst, arg_type n)
+    {
+        arg_type i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+        }
+#endif
+        for (; i < n; ++i) dst[i] = src[i];
+    }
+
+    inline void
+    narrow(const float* src, bfloat16* dst, arg_type n)
+    {
+        for (arg_type i = 0; i < n; ++i) dst[i] = src[i];
+    }
+}
+
+// ----------------- FLOAT16 -----------------
+
+inline float16::float16(float value)
+    : h_bits(detail::float_to_half_bits(value))
+{}
+
+inline float16::operator float() const
+{
+    return detail::half_bits_to_float(h_bits);
+}
+
+inline float16&
+float16::operator+=(float rhv)
+{
+    return *this = float16(float(*this) + rhv);
+}
+
+inline float16&
+float16::operator-=(float rhv)
+{
+    return *this = float16(float(*this) - rhv);
+}
+
+inline float16&
+float16::operator*=(float rhv)
+{
+    return *this = float16(float(*this) * rhv);
+}
+
+inline float16&
+float16::operator/=(float rhv)
+{
+    return *this = float16(float(*this) / rhv);
+}
+
+inline std::uint16_t
+float16::bits() const
+{
+    return h_bits;
+}
+
+inline float16
+float16::from_bits(std::uint16_t bits)
+{
+    float16 res;
+    res.h_bits = bits;
+    return res;
+}
+
+// ----------------- BFLOAT16 -----------------
+
+inline bfloat16::bfloat16(float value)
+    : h_bits(detail::float_to_bfloat_bits(value))
+{}
+
+inline bfloat16::operator float() const
+{
+    return detail::bfloat_bits_to_float(h_bits);
+}
+
+inline bfloat16&
+bfloat16::operator+=(float rhv)
+{
+    return *this = bfloat16(float(*this) + rhv);
+}
+
+inline bfloat16&
+bfloat16::operator-=(float rhv)
+{
+    return *this = bfloat16(float(*this) - rhv);
+}
+
+inline bfloat16&
+bfloat16::operator*=(float rhv)
+{
+    return *this = bfloat16(float(*this) * rhv);
+}
+
+inline bfloat16&
+bfloat16::operator/=(float rhv)
+{
+    return *this = bfloat16(float(*this) / rhv);
+}
+
+inline std::uint16_t
+bfloat16::bits() const
+{
+    return h_bits;
+}
+
+inline bfloat16
+bfloat16::from_bits(std::uint16_t bits)
+{
+    bfloat16 res;
+    res.h_bits = bits;
+    return res;
+}
+
+inline std::ostream&
+operator<<(std::ostream& out, float16 value)
+{
+    return out << static_cast<float>(value);
+}
+
+inline std::ostream&
+operator<<(std::ostream& out, bfloat16 value)
+{
+    return out << static_cast<float>(value);
+}
+
+}
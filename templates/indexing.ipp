@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace SamH::NumC
+{
+
+namespace detail
+{
+    // Gathers issue a prefetch this many elements ahead of the load
+    constexpr arg_type PREFETCH_DISTANCE = 16;
+    // Scatters touching fewer values run serially
+    constexpr arg_type SCATTER_SERIAL = arg_type(1) << 15;
+    // Largest total size of per-task accumulators for scatter_add
+    constexpr arg_type SCATTER_PRIVATE_LIMIT = arg_type(1) << 24;
+
+    inline arg_type wrap_index(arg_type index, arg_type n)
+    {
+        const arg_type i = index < 0 ? index + n : index;
+        if (i < 0 || i >= n) throw std::out_of_range("Array::Index " + std::to_string(index) + " is out of range");
+        return i;
+    }
+
+    // Prefetch target only, never dereferenced, so no range check
+    inline arg_type prefetch_index(arg_type index, arg_type n)
+    {
+        return index < 0 ? index + n : index;
+    }
+
+    inline arg_type normalize_axis(arg_type axis, arg_type ndim)
+    {
+        const arg_type a = axis < 0 ? axis + ndim : axis;
+        if (a < 0 || a >= ndim) throw std::invalid_argument("Array::Axis out of range");
+        return a;
+    }
+
+    // dst[i] = src[indices[i]] over one lane of n values
+    template <typename T>
+    void gather_values(const T* src, arg_type n, const arg_type* indices, arg_type count, T* dst)
+    {
+        // Ascending indices: copy runs of consecutive positions, the hardware prefetcher
+        // already follows the rest
+        if (std::is_sorted(indices, indices + count)) {
+            for (arg_type i = 0; i < count;) {
+                const arg_type first = indices[i];
+                arg_type run = 1;
+                if (first >= 0) {
+                    while (i + run < count && indices[i + run] == first + run) ++run;
+                }
+                const arg_type start = wrap_index(first, n);
+                wrap_index(start + run - 1, n);
+                std::copy(src + start, src + start + run, dst + i);
+                i += run;
+            }
+            return;
+        }
+
+        arg_type i = 0;
+#if defined(__AVX2__)
+        if constexpr (sizeof(T) == 8 && std::is_arithmetic_v<T>) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i size = _mm256_set1_epi64x(n);
+            const __m256i last = _mm256_set1_epi64x(n - 1);
+            for (; i + 4 <= count; i += 4) {
+                __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+                idx = _mm256_add_epi64(idx, _mm256_and_si256(_mm256_cmpgt_epi64(zero, idx), size));
+                const __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi64(zero, idx), _mm256_cmpgt_epi64(idx, last));
+                // Leave out-of-range indices to the scalar loop, which reports them
+                if (!_mm256_testz_si256(bad, bad)) break;
+                if (i + PREFETCH_DISTANCE + 4 <= count) {
+                    for (arg_type l = 0; l < 4; ++l) __builtin_prefetch(src + prefetch_index(indices[i + PREFETCH_DISTANCE + l], n));
+                }
+                const __m256i values = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), idx, 8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), values);
+            }
+        }
+#endif
+        for (; i < count; ++i) {
+            if (i + PREFETCH_DISTANCE < count) __builtin_prefetch(src + prefetch_index(indices[i + PREFETCH_DISTANCE], n));
+            dst[i] = src[wrap_index(indices[i], n)];
+        }
+    }
+}
+
+template <typename T>
+void
+detail::gather_rows(const T* src, arg_type outer, arg_type n, arg_type inner,
+                    const arg_type* indices, arg_type k, T* dst)
+{
+    const arg_type rows = outer * k;
+    if (inner == 1) {
+        // Chunks of the (outer, k) output, split where a chunk crosses into the next lane
+        Parallel::parallel_for(0, rows, [&](arg_type b, arg_type e) {
+            while (b < e) {
+                const arg_type o = b / k;
+                const arg_type j = b % k;
+                const arg_type count = std::min(e - b, k - j);
+                detail::gather_values(src + o * n, n, indices + j, count, dst + b);
+                b += count;
+            }
+        });
+        return;
+    }
+
+    const arg_type grain = std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / inner);
+    Parallel::parallel_for(0, rows, [&](arg_type b, arg_type e) {
+        for (arg_type r = b; r < e; ++r) {
+            const arg_type o = r / k;
+            const arg_type j = r % k;
+            if (r + 1 < e) {
+                const arg_type next = r + 1;
+                __builtin_prefetch(src + ((next / k) * n + prefetch_index(indices[next % k], n)) * inner);
+            }
+            const T* row = src + (o * n + wrap_index(indices[j], n)) * inner;
+            std::copy(row, row + inner, dst + r * inner);
+        }
+    }, grain);
+}
+
+template <typename T, typename Op>
+void
+detail::scatter_rows(T* dst, arg_type outer, arg_type n, arg_type inner,
+                     const arg_type* indices, arg_type k, const T* values, bool broadcast, Op op)
+{
+    std::vector<arg_type> target(k);
+    Parallel::parallel_for(0, k, [&](arg_type b, arg_type e) {
+        for (arg_type j = b; j < e; ++j) target[j] = wrap_index(indices[j], n);
+    });
+
+    auto apply = [&](arg_type j) {
+        for (arg_type o = 0; o < outer; ++o) {
+            T* out = dst + (o * n + target[j]) * inner;
+            const T* in = values + (broadcast ? 0 : (o * k + j) * inner);
+            for (arg_type c = 0; c < inner; ++c) op(out[c], in[broadcast ? 0 : c]);
+        }
+    };
+
+    const arg_type tasks = Parallel::num_threads();
+    if (outer * k * inner < SCATTER_SERIAL || tasks == 1) {
+        for (arg_type j = 0; j < k; ++j) apply(j);
+        return;
+    }
+
+    // Stable counting sort of the index positions by destination range
+    const arg_type chunks = Parallel::chunk_count(k);
+    std::vector<arg_type> position(chunks * tasks, 0);
+    auto range_of = [&](arg_type j) { return target[j] * tasks / n; };
+    Parallel::parallel_chunks(0, k, chunks, [&](arg_type c, arg_type b, arg_type e) {
+        arg_type* counts = position.data() + c * tasks;
+        for (arg_type j = b; j < e; ++j) ++counts[range_of(j)];
+    });
+
+    std::vector<arg_type> range_start(tasks + 1, 0);
+    for (arg_type t = 0, offset = 0; t < tasks; ++t) {
+        range_start[t] = offset;
+        for (arg_type c = 0; c < chunks; ++c) {
+            const arg_type count = position[c * tasks + t];
+            position[c * tasks + t] = offset;
+            offset += count;
+        }
+        range_start[t + 1] = offset;
+    }
+
+    std::vector<arg_type> order(k);
+    Parallel::parallel_chunks(0, k, chunks, [&](arg_type c, arg_type b, arg_type e) {
+        arg_type* next = position.data() + c * tasks;
+        for (arg_type j = b; j < e; ++j) order[next[range_of(j)]++] = j;
+    });
+
+    Parallel::parallel_for(0, tasks, [&](arg_type b, arg_type e) {
+        for (arg_type t = b; t < e; ++t) {
+            for (arg_type p = range_start[t]; p < range_start[t + 1]; ++p) apply(order[p]);
+        }
+    }, 1);
+}
+
+template <typename T>
+void
+detail::scatter_add_rows(T* dst, arg_type outer, arg_type n, arg_type inner,
+                         const arg_type* indices, arg_type k, const T* values, bool broadcast)
+{
+    auto add = [](T& out, const T& in) { out += in; };
+    const arg_type target_size = outer * n * inner;
+    const arg_type work = outer * k * inner;
+    const arg_type chunks = Parallel::chunk_count(k, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / (outer * inner)));
+    if (work < SCATTER_SERIAL || chunks == 1 || target_size * chunks > std::min(work, SCATTER_PRIVATE_LIMIT)) {
+        scatter_rows(dst, outer, n, inner, indices, k, values, broadcast, add);
+        return;
+    }
+
+    std::vector<T> partial(chunks * target_size, T(0));
+    Parallel::parallel_chunks(0, k, chunks, [&](arg_type c, arg_type b, arg_type e) {
+        T* mine = partial.data() + c * target_size;
+        for (arg_type j = b; j < e; ++j) {
+            const arg_type t = wrap_index(indices[j], n);
+            for (arg_type o = 0; o < outer; ++o) {
+                T* out = mine + (o * n + t) * inner;
+                const T* in = values + (broadcast ? 0 : (o * k + j) * inner);
+                for (arg_type i = 0; i < inner; ++i) out[i] += in[broadcast ? 0 : i];
+            }
+        }
+    });
+    // Summed in chunk order, so results don't depend on scheduling
+    Parallel::parallel_for(0, target_size, [&](arg_type b, arg_type e) {
+        for (arg_type c = 0; c < chunks; ++c) {
+            const T* mine = partial.data() + c * target_size;
+            for (arg_type i = b; i < e; ++i) dst[i] += mine[i];
+        }
+    });
+}
+
+// ----------------- GATHER -----------------
+
+template <typename T>
+Array<T>
+Array<T>::operator[](const Array<arg_type>& indices) const
+{
+    return take(indices);
+}
+
+template <typename T>
+Array<T>
+Array<T>::take(const Array<arg_type>& indices) const
+{
+    Array<T> res = Array<T>::uninitialized(indices.shape());
+    detail::gather_rows(data(), 1, size(), 1, indices.data(), indices.size(), res.data());
+    return res;
+}
+
+template <typename T>
+Array<T>
+Array<T>::take(const Array<arg_type>& indices, arg_type axis) const
+{
+    const arg_type ndim = n_dims.size();
+    axis = detail::normalize_axis(axis, ndim);
+
+    arg_type outer = 1;
+    arg_type inner = 1;
+    Shape shape;
+    for (arg_type d = 0; d < axis; ++d) {
+        outer *= n_dims[d];
+        shape.push_back(n_dims[d]);
+    }
+    for (arg_type d : indices.shape()) shape.push_back(d);
+    for (arg_type d = axis + 1; d < ndim; ++d) {
+        inner *= n_dims[d];
+        shape.push_back(n_dims[d]);
+    }
+
+    Array<T> res = Array<T>::uninitialized(shape);
+    detail::gather_rows(data(), outer, n_dims[axis], inner, indices.data(), indices.size(), res.data());
+    return res;
+}
+
+// ----------------- SCATTER -----------------
+
+template <typename T>
+void
+Array<T>::put(const Array<arg_type>& indices, const Array<T>& values)
+{
+    if (values.size() != 1 && values.size() != indices.size()) {
+        throw std::invalid_argument("Array::put needs one value per index");
+    }
+    detail::scatter_rows(data(), 1, size(), 1, indices.data(), indices.size(), values.data(),
+                         values.size() == 1 && indices.size() != 1, [](T& out, const T& in) { out = in; });
+}
+
+template <typename T>
+void
+Array<T>::scatter_add(const Array<arg_type>& indices, const Array<T>& values)
+{
+    if (values.size() != 1 && values.size() != indices.size()) {
+        throw std::invalid_argument("Array::scatter_add needs one value per index");
+    }
+    detail::scatter_add_rows(data(), 1, size(), 1, indices.data(), indices.size(), values.data(),
+                             values.size() == 1 && indices.size() != 1);
+}
+
+template <typename T>
+void
+Array<T>::put(const Array<arg_type>& indices, const Array<T>& values, arg_type axis)
+{
+    axis = detail::normalize_axis(axis, n_dims.size());
+    const arg_type n = n_dims[axis];
+    const arg_type k = indices.size();
+    const arg_type outer = std::accumulate(n_dims.begin(), n_dims.begin() + axis, arg_type(1), std::multiplies<arg_type>());
+    const arg_type inner = size() / std::max<arg_type>(1, outer * n);
+    if (values.size() != 1 && values.size() != outer * k * inner) {
+        throw std::invalid_argument("Array::put needs one slice per index");
+    }
+    detail::scatter_rows(data(), outer, n, inner, indices.data(), k, values.data(),
+                         values.size() == 1 && outer * k * inner != 1, [](T& out, const T& in) { out = in; });
+}
+
+template <typename T>
+void
+Array<T>::scatter_add(const Array<arg_type>& indices, const Array<T>& values, arg_type axis)
+{
+    axis = detail::normalize_axis(axis, n_dims.size());
+    const arg_type n = n_dims[axis];
+    const arg_type k = indices.size();
+    const arg_type outer = std::accumulate(n_dims.begin(), n_dims.begin() + axis, arg_type(1), std::multiplies<arg_type>());
+    const arg_type inner = size() / std::max<arg_type>(1, outer * n);
+    if (values.size() != 1 && values.size() != outer * k * inner) {
+        throw std::invalid_argument("Array::scatter_add needs one slice per index");
+    }
+    detail::scatter_add_rows(data(), outer, n, inner, indices.data(), k, values.data(),
+                             values.size() == 1 && outer * k * inner != 1);
+}
+
+}
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace SamH::NumC::Global::Linalg
+{
+
+namespace detail
+{
+    // Matrices factored side by side; the innermost loops run over these lanes
+    constexpr arg_type LINALG_LANES = 8;
+
+    inline void check_square(const Shape& shape)
+    {
+        if (shape.size() < 2 || shape[shape.size() - 1] != shape[shape.size() - 2]) {
+            throw std::invalid_argument("Linalg::Expected a stack of square matrices");
+        }
+    }
+
+    inline Shape batch_shape(const Shape& shape)
+    {
+        return Shape(shape.begin(), shape.end() - 2);
+    }
+
+    inline arg_type batch_size(const Shape& shape)
+    {
+        return batch_shape(shape).total();
+    }
+
+    // Spreads groups of LINALG_LANES matrices over the pool; f(first_group, last_group)
+    template <typename F>
+    void for_each_group(arg_type batch, arg_type work_per_matrix, F&& f)
+    {
+        const arg_type groups = (batch + LINALG_LANES - 1) / LINALG_LANES;
+        const arg_type grain = std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / (std::max<arg_type>(1, work_per_matrix) * LINALG_LANES));
+        Parallel::parallel_for(0, groups, f, grain);
+    }
+
+    // count matrices of `elems` values each -> element-major layout with one matrix per
+    // lane. Unused lanes get identity matrices of order k (k == 0: zeros), so they stay regular.
+    template <typename T, typename W>
+    void interleave(const T* src, arg_type count, arg_type elems, arg_type k, W* dst)
+    {
+        for (arg_type e = 0; e < elems; ++e) {
+            W* lanes = dst + e * LINALG_LANES;
+            for (arg_type l = 0; l < count; ++l) lanes[l] = static_cast<W>(src[l * elems + e]);
+            const W pad = (k && e % (k + 1) == 0) ? W(1) : W(0);
+            for (arg_type l = count; l < LINALG_LANES; ++l) lanes[l] = pad;
+        }
+    }
+
+    template <typename W, typename T>
+    void deinterleave(const W* src, arg_type count, arg_type elems, T* dst)
+    {
+        for (arg_type l = 0; l < count; ++l) {
+            for (arg_type e = 0; e < elems; ++e) dst[l * elems + e] = static_cast<T>(src[e * LINALG_LANES + l]);
+        }
+    }
+
+    // Gaussian elimination with partial pivoting, chosen independently in every lane.
+    // a (k x k) becomes upper triangular, the same row operations are applied to b (k x m).
+    template <typename W>
+    void eliminate(W* a, W* b, arg_type k, arg_type m, W* det, bool* singular)
+    {
+        constexpr arg_type L = LINALG_LANES;
+        W scale[L];
+        for (arg_type l = 0; l < L; ++l) {
+            det[l] = W(1);
+            singular[l] = false;
+        }
+
+        for (arg_type i = 0; i < k; ++i) {
+            for (arg_type l = 0; l < L; ++l) {
+                arg_type pivot = i;
+                W best = std::abs(a[(i * k + i) * L + l]);
+                for (arg_type r = i + 1; r < k; ++r) {
+                    const W v = std::abs(a[(r * k + i) * L + l]);
+                    if (v > best) {
+                        best = v;
+                        pivot = r;
+                    }
+                }
+                if (pivot != i) {
+                    for (arg_type c = i; c < k; ++c) std::swap(a[(i * k + c) * L + l], a[(pivot * k + c) * L + l]);
+                    for (arg_type c = 0; c < m; ++c) std::swap(b[(i * m + c) * L + l], b[(pivot * m + c) * L + l]);
+                    det[l] = -det[l];
+                }
+                const W p = a[(i * k + i) * L + l];
+                det[l] *= p;
+                singular[l] = singular[l] || p == W(0);
+                scale[l] = p == W(0) ? W(0) : W(1) / p;
+            }
+
+            const W* pivot_row = a + i * k * L;
+            const W* pivot_rhs = b + i * m * L;
+            for (arg_type r = i + 1; r < k; ++r) {
+                W* row = a + r * k * L;
+                W f[L];
+                for (arg_type l = 0; l < L; ++l) f[l] = row[i * L + l] * scale[l];
+                for (arg_type c = i + 1; c < k; ++c) {
+                    for (arg_type l = 0; l < L; ++l) row[c * L + l] -= f[l] * pivot_row[c * L + l];
+                }
+                W* rhs = b + r * m * L;
+                for (arg_type c = 0; c < m; ++c) {
+                    for (arg_type l = 0; l < L; ++l) rhs[c * L + l] -= f[l] * pivot_rhs[c * L + l];
+                }
+            }
+        }
+    }
+
+    // Solves the triangular system left by eliminate(), b is overwritten with x
+    template <typename W>
+    void back_substitute(const W* a, W* b, arg_type k, arg_type m)
+    {
+        constexpr arg_type L = LINALG_LANES;
+        for (arg_type i = k - 1; i >= 0; --i) {
+            W inv_diag[L];
+            for (arg_type l = 0; l < L; ++l) {
+                const W d = a[(i * k + i) * L + l];
+                inv_diag[l] = d == W(0) ? W(0) : W(1) / d;
+            }
+            for (arg_type c = 0; c < m; ++c) {
+                W acc[L];
+                for (arg_type l = 0; l < L; ++l) acc[l] = b[(i * m + c) * L + l];
+                for (arg_type j = i + 1; j < k; ++j) {
+                    const W* aij = a + (i * k + j) * L;
+                    const W* xj = b + (j * m + c) * L;
+                    for (arg_type l = 0; l < L; ++l) acc[l] -= aij[l] * xj[l];
+                }
+                for (arg_type l = 0; l < L; ++l) b[(i * m + c) * L + l] = acc[l] * inv_diag[l];
+            }
+        }
+    }
+
+    inline void check_regular(const bool* singular, arg_type count)
+    {
+        for (arg_type l = 0; l < count; ++l) {
+            if (singular[l]) throw std::runtime_error("Linalg::Singular matrix");
+        }
+    }
+
+    // Batched A x = B; b holds `m` right-hand sides per matrix, nullptr for the identity
+    template <typename T>
+    void solve_batch(const T* a, const T* b, arg_type batch, arg_type k, arg_type m, work_type<T>* x)
+    {
+        using W = work_type<T>;
+        for_each_group(batch, k * k * (k + m), [&](arg_type first_group, arg_type last_group) {
+            std::vector<W> lu(k * k * LINALG_LANES);
+            std::vector<W> rhs(k * m * LINALG_LANES);
+            W det[LINALG_LANES];
+            bool singular[LINALG_LANES];
+            for (arg_type g = first_group; g < last_group; ++g) {
+                const arg_type first = g * LINALG_LANES;
+                const arg_type count = std::min(LINALG_LANES, batch - first);
+                interleave(a + first * k * k, count, k * k, k, lu.data());
+                if (b) {
+                    interleave(b + first * k * m, count, k * m, 0, rhs.data());
+                } else {
+                    interleave(static_cast<const T*>(nullptr), 0, k * m, k, rhs.data());
+                }
+                eliminate(lu.data(), rhs.data(), k, m, det, singular);
+                check_regular(singular, count);
+                back_substitute(lu.data(), rhs.data(), k, m);
+                deinterleave(rhs.data(), count, k * m, x + first * k * m);
+            }
+        });
+    }
+}
+
+// ----------------- DETERMINANT -----------------
+
+template <typename T>
+Array<T>
+det(const Array<T>& arr)
+{
+    using W = work_type<T>;
+    detail::check_square(arr.shape());
+    const arg_type k = arr.shape()[arr.shape().size() - 1];
+    const arg_type batch = detail::batch_size(arr.shape());
+
+    Shape shape = detail::batch_shape(arr.shape());
+    if (shape.size() == 0) shape = Shape{1};
+    Array<T> res = Array<T>::uninitialized(shape);
+
+    const T* src = arr.data();
+    T* out = res.data();
+    detail::for_each_group(batch, k * k * k, [&](arg_type first_group, arg_type last_group) {
+        std::vector<W> lu(k * k * detail::LINALG_LANES);
+        W det[detail::LINALG_LANES];
+        bool singular[detail::LINALG_LANES];
+        for (arg_type g = first_group; g < last_group; ++g) {
+            const arg_type first = g * detail::LINALG_LANES;
+            const arg_type count = std::min(detail::LINALG_LANES, batch - first);
+            detail::interleave(src + first * k * k, count, k * k, k, lu.data());
+            detail::eliminate(lu.data(), static_cast<W*>(nullptr), k, 0, det, singular);
+            for (arg_type l = 0; l < count; ++l) {
+                if constexpr (std::is_integral_v<T>) out[first + l] = static_cast<T>(std::llround(det[l]));
+                else out[first + l] = static_cast<T>(det[l]);
+            }
+        }
+    });
+    return res;
+}
+
+// ----------------- INVERSE / SOLVE -----------------
+
+template <typename T>
+Array<work_type<T>>
+inv(const Array<T>& arr)
+{
+    detail::check_square(arr.shape());
+    const arg_type k = arr.shape()[arr.shape().size() - 1];
+    Array<work_type<T>> res = Array<work_type<T>>::uninitialized(arr.shape());
+    detail::solve_batch(arr.data(), static_cast<const T*>(nullptr), detail::batch_size(arr.shape()), k, k, res.data());
+    return res;
+}
+
+template <typename T>
+Array<work_type<T>>
+solve(const Array<T>& a, const Array<T>& b)
+{
+    detail::check_square(a.shape());
+    const Shape& sa = a.shape();
+    const Shape& sb = b.shape();
+    const arg_type k = sa[sa.size() - 1];
+    const Shape batch = detail::batch_shape(sa);
+
+    // b is either a stack of vectors or a stack of k x m matrices with the same batch
+    arg_type m = 0;
+    if (sb.size() == sa.size() - 1 && Shape(sb.begin(), sb.end() - 1) == batch && sb[sb.size() - 1] == k) {
+        m = 1;
+    } else if (sb.size() == sa.size() && detail::batch_shape(sb) == batch && sb[sb.size() - 2] == k) {
+        m = sb[sb.size() - 1];
+    } else {
+        throw std::invalid_argument("Linalg::solve right-hand side doesn't match the matrices");
+    }
+
+    Array<work_type<T>> res = Array<work_type<T>>::uninitialized(sb);
+    detail::solve_batch(a.data(), b.data(), batch.total(), k, m, res.data());
+    return res;
+}
+
+// ----------------- PRODUCT -----------------
+
+template <typename T>
+Array<T>
+matmul(const Array<T>& a, const Array<T>& b)
+{
+    const Shape& sa = a.shape();
+    const Shape& sb = b.shape();
+    if (sa.size() < 2 || sb.size() < 2) throw std::invalid_argument("Linalg::matmul requires matrices");
+    const arg_type k = sa[sa.size() - 2];
+    const arg_type m = sa[sa.size() - 1];
+    const arg_type p = sb[sb.size() - 1];
+    if (sb[sb.size() - 2] != m) throw std::invalid_argument("Linalg::matmul inner dimensions don't match");
+
+    // A 2-D operand is reused for every matrix of the other one
+    Shape batch;
+    if (sa.size() == 2) {
+        batch = detail::batch_shape(sb);
+    } else if (sb.size() == 2 || detail::batch_shape(sa) == detail::batch_shape(sb)) {
+        batch = detail::batch_shape(sa);
+    } else {
+        throw std::invalid_argument("Linalg::matmul batch shapes don't match");
+    }
+    const arg_type stride_a = sa.size() == 2 ? 0 : k * m;
+    const arg_type stride_b = sb.size() == 2 ? 0 : m * p;
+    const arg_type count = batch.total();
+
+    Shape shape(batch.begin(), batch.end());
+    shape.push_back(k);
+    shape.push_back(p);
+    Array<T> res = Array<T>::uninitialized(shape);
+
+    const T* pa = a.data();
+    const T* pb = b.data();
+    T* out = res.data();
+    const arg_type grain = std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / std::max<arg_type>(1, k * m * p));
+    Parallel::parallel_for(0, count, [&](arg_type begin, arg_type end) {
+        for (arg_type n = begin; n < end; ++n) {
+            const T* lhs = pa + n * stride_a;
+            const T* rhs = pb + n * stride_b;
+            T* dst = out + n * k * p;
+            for (arg_type i = 0; i < k; ++i) {
+                T* row = dst + i * p;
+                std::fill(row, row + p, T(0));
+                for (arg_type t = 0; t < m; ++t) {
+                    const T scale = lhs[i * m + t];
+                    const T* src = rhs + t * p;
+                    for (arg_type j = 0; j < p; ++j) row[j] += scale * src[j];
+                }
+            }
+        }
+    }, grain);
+    return res;
+}
+
+}
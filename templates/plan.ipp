@@ -0,0 +1,580 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace SamH::NumC::Pipeline
+{
+
+namespace detail
+{
+    // Elements evaluated per fused pass; every stage's block stays in L1
+    constexpr arg_type PLAN_BLOCK = 256;
+
+    inline Shape broadcast_shape(const Shape& a, const Shape& b)
+    {
+        const arg_type ndim = std::max(a.size(), b.size());
+        const arg_type lead_a = ndim - a.size();
+        const arg_type lead_b = ndim - b.size();
+        Shape res(ndim);
+        for (arg_type j = 0; j < ndim; ++j) {
+            const arg_type da = j < lead_a ? 1 : a[j - lead_a];
+            const arg_type db = j < lead_b ? 1 : b[j - lead_b];
+            if (da != db && da != 1 && db != 1) throw std::invalid_argument("Plan::Shapes can't be broadcast");
+            res[j] = da == 1 ? db : da;
+        }
+        return res;
+    }
+
+    // dst[i] = base[offset of element begin + i] under broadcast strides
+    template <typename T>
+    void gather(const T* base, const Shape& shape, const Shape& strides, arg_type begin, arg_type n, T* dst)
+    {
+        const arg_type ndim = shape.size();
+        Shape coords(ndim, 0);
+        arg_type offset = 0;
+        for (arg_type j = ndim - 1, rem = begin; j >= 0; --j) {
+            coords[j] = rem % shape[j];
+            rem /= shape[j];
+            offset += coords[j] * strides[j];
+        }
+        for (arg_type i = 0; i < n; ++i) {
+            dst[i] = base[offset];
+            for (arg_type j = ndim - 1; j >= 0; --j) {
+                offset += strides[j];
+                if (++coords[j] < shape[j]) break;
+                offset -= strides[j] * shape[j];
+                coords[j] = 0;
+            }
+        }
+    }
+
+    template <typename T>
+    void apply(Op op, const T* const* in, T* out, arg_type n)
+    {
+        const T* a = in[0];
+        const T* b = in[1];
+        const T* c = in[2];
+        switch (op) {
+            case IDENTITY: for (arg_type i = 0; i < n; ++i) out[i] = a[i]; break;
+            case ADD:      for (arg_type i = 0; i < n; ++i) out[i] = a[i] + b[i]; break;
+            case SUBTRACT: for (arg_type i = 0; i < n; ++i) out[i] = a[i] - b[i]; break;
+            case MULTIPLY: for (arg_type i = 0; i < n; ++i) out[i] = a[i] * b[i]; break;
+            case DIVIDE:   for (arg_type i = 0; i < n; ++i) out[i] = a[i] / b[i]; break;
+            case NEGATE:   for (arg_type i = 0; i < n; ++i) out[i] = -a[i]; break;
+            case EXP:      for (arg_type i = 0; i < n; ++i) out[i] = static_cast<T>(std::exp(a[i])); break;
+            case LOG:      for (arg_type i = 0; i < n; ++i) out[i] = static_cast<T>(std::log(a[i])); break;
+            case SQRT:     for (arg_type i = 0; i < n; ++i) out[i] = static_cast<T>(std::sqrt(a[i])); break;
+            case ABS:      for (arg_type i = 0; i < n; ++i) out[i] = a[i] < T(0) ? -a[i] : a[i]; break;
+            case GREATER:  for (arg_type i = 0; i < n; ++i) out[i] = a[i] > b[i] ? T(1) : T(0); break;
+            case LESS:     for (arg_type i = 0; i < n; ++i) out[i] = a[i] < b[i] ? T(1) : T(0); break;
+            case EQUAL:    for (arg_type i = 0; i < n; ++i) out[i] = a[i] == b[i] ? T(1) : T(0); break;
+            case WHERE:    for (arg_type i = 0; i < n; ++i) out[i] = a[i] != T(0) ? b[i] : c[i]; break;
+            default: throw std::logic_error("Plan::Not an elementwise operation");
+        }
+    }
+
+    inline const char* op_name(Op op)
+    {
+        switch (op) {
+            case IDENTITY: return "copy";
+            case ADD:      return "add";
+            case SUBTRACT: return "subtract";
+            case MULTIPLY: return "multiply";
+            case DIVIDE:   return "divide";
+            case NEGATE:   return "negate";
+            case EXP:      return "exp";
+            case LOG:      return "log";
+            case SQRT:     return "sqrt";
+            case ABS:      return "abs";
+            case GREATER:  return "greater";
+            case LESS:     return "less";
+            case EQUAL:    return "equal";
+            case WHERE:    return "where";
+            case SUM:      return "sum";
+            default:       return "?";
+        }
+    }
+}
+
+// ----------------- RECORDING -----------------
+
+template <typename T>
+typename Plan<T>::Handle
+Plan<T>::record(Op op, std::initializer_list<Handle> args, const Shape& shape, T value)
+{
+    if (p_compiled) throw std::runtime_error("Plan::Can't record after compile");
+    Node n{op, {-1, -1, -1}, 0, value, shape};
+    for (Handle a : args) {
+        node(a);
+        n.args[n.arity++] = a;
+    }
+    p_nodes.push_back(n);
+    return static_cast<Handle>(p_nodes.size()) - 1;
+}
+
+template <typename T>
+typename Plan<T>::Handle
+Plan<T>::elementwise(Op op, std::initializer_list<Handle> args)
+{
+    Shape shape = node(*args.begin()).shape;
+    for (Handle a : args) shape = detail::broadcast_shape(shape, node(a).shape);
+    return record(op, args, shape);
+}
+
+template <typename T>
+const typename Plan<T>::Node&
+Plan<T>::node(Handle handle) const
+{
+    if (handle < 0 || handle >= static_cast<Handle>(p_nodes.size())) {
+        throw std::out_of_range("Plan::Unknown node");
+    }
+    return p_nodes[handle];
+}
+
+template <typename T>
+typename Plan<T>::Handle
+Plan<T>::input(const Shape& shape)
+{
+    const Handle h = record(INPUT, {}, shape);
+    p_nodes[h].args[0] = static_cast<arg_type>(p_input_shapes.size());
+    p_input_shapes.push_back(shape);
+    return h;
+}
+
+template <typename T>
+typename Plan<T>::Handle
+Plan<T>::constant(T value)
+{
+    return record(CONSTANT, {}, Shape{1}, value);
+}
+
+#define DEFINE_PLAN_UNARY(NAME, OP) \
+template <typename T> \
+typename Plan<T>::Handle \
+Plan<T>::NAME(Handle a) { return elementwise(OP, {a}); }
+
+#define DEFINE_PLAN_BINARY(NAME, OP) \
+template <typename T> \
+typename Plan<T>::Handle \
+Plan<T>::NAME(Handle a, Handle b) { return elementwise(OP, {a, b}); }
+
+DEFINE_PLAN_BINARY(add,      ADD)
+DEFINE_PLAN_BINARY(subtract, SUBTRACT)
+DEFINE_PLAN_BINARY(multiply, MULTIPLY)
+DEFINE_PLAN_BINARY(divide,   DIVIDE)
+DEFINE_PLAN_BINARY(greater,  GREATER)
+DEFINE_PLAN_BINARY(less,     LESS)
+DEFINE_PLAN_BINARY(equal,    EQUAL)
+
+DEFINE_PLAN_UNARY(negate, NEGATE)
+DEFINE_PLAN_UNARY(exp,    EXP)
+DEFINE_PLAN_UNARY(log,    LOG)
+DEFINE_PLAN_UNARY(sqrt,   SQRT)
+DEFINE_PLAN_UNARY(abs,    ABS)
+
+#undef DEFINE_PLAN_UNARY
+#undef DEFINE_PLAN_BINARY
+
+template <typename T>
+typename Plan<T>::Handle
+Plan<T>::where(Handle condition, Handle x, Handle y)
+{
+    return elementwise(WHERE, {condition, x, y});
+}
+
+template <typename T>
+typename Plan<T>::Handle
+Plan<T>::sum(Handle a)
+{
+    return record(SUM, {a}, Shape{1});
+}
+
+template <typename T>
+arg_type
+Plan<T>::output(Handle handle)
+{
+    const Op op = node(handle).op;
+    const bool taken = std::find(p_outputs.begin(), p_outputs.end(), handle) != p_outputs.end();
+    // Leaves and repeated results get a node of their own to materialize into
+    if (op == INPUT || op == CONSTANT || taken) handle = record(IDENTITY, {handle}, node(handle).shape);
+    else if (p_compiled) throw std::runtime_error("Plan::Can't record after compile");
+    p_outputs.push_back(handle);
+    return static_cast<arg_type>(p_outputs.size()) - 1;
+}
+
+// ----------------- COMPILATION -----------------
+
+template <typename T>
+bool
+Plan<T>::is_elementwise(Op op) const
+{
+    return op != INPUT && op != CONSTANT && op != SUM;
+}
+
+template <typename T>
+typename Plan<T>::Operand
+Plan<T>::leaf(Handle handle, const Shape& shape) const
+{
+    const Node& n = node(handle);
+    Operand res{FROM_BUFFER, handle, n.value, Shape(shape.size(), 0), n.shape == shape};
+    if (n.op == CONSTANT) {
+        res.source = FROM_CONSTANT;
+        return res;
+    }
+    if (n.op == INPUT) {
+        res.source = FROM_INPUT;
+        res.index = n.args[0];
+    }
+
+    const arg_type lead = shape.size() - n.shape.size();
+    const Shape own = n.shape.strides();
+    for (arg_type j = lead; j < static_cast<arg_type>(shape.size()); ++j) {
+        if (n.shape[j - lead] == shape[j] && shape[j] > 1) res.strides[j] = own[j - lead];
+    }
+    return res;
+}
+
+template <typename T>
+arg_type
+Plan<T>::collect(Handle handle, const std::vector<bool>& fused, const Shape& shape, Step& step) const
+{
+    const Node& n = node(handle);
+    Stage stage{n.op, {}, n.arity};
+    for (arg_type k = 0; k < n.arity; ++k) {
+        const Handle a = n.args[k];
+        if (fused[a]) {
+            stage.args[k] = Operand{FROM_STAGE, collect(a, fused, shape, step), T(), Shape(), true};
+        } else {
+            stage.args[k] = leaf(a, shape);
+        }
+    }
+    step.stages.push_back(stage);
+    return static_cast<arg_type>(step.stages.size()) - 1;
+}
+
+template <typename T>
+void
+Plan<T>::compile()
+{
+    if (p_compiled) return;
+    const arg_type count = p_nodes.size();
+
+    std::vector<bool> is_output(count, false);
+    std::vector<arg_type> output_index(count, -1);
+    for (std::size_t k = 0; k < p_outputs.size(); ++k) {
+        is_output[p_outputs[k]] = true;
+        output_index[p_outputs[k]] = k;
+    }
+
+    // Only nodes an output depends on are computed
+    std::vector<bool> live(is_output);
+    for (Handle h = count - 1; h >= 0; --h) {
+        if (!live[h]) continue;
+        for (arg_type k = 0; k < p_nodes[h].arity; ++k) live[p_nodes[h].args[k]] = true;
+    }
+
+    std::vector<arg_type> consumers(count, 0);
+    std::vector<Handle> consumer(count, -1);
+    for (Handle h = 0; h < count; ++h) {
+        if (!live[h]) continue;
+        for (arg_type k = 0; k < p_nodes[h].arity; ++k) {
+            ++consumers[p_nodes[h].args[k]];
+            consumer[p_nodes[h].args[k]] = h;
+        }
+    }
+
+    // An elementwise node with a single reader of the same shape (or a sum) is evaluated
+    // inside that reader's pass instead of being stored
+    std::vector<bool> fused(count, false);
+    for (Handle h = 0; h < count; ++h) {
+        const Node& n = p_nodes[h];
+        if (!live[h] || !is_elementwise(n.op) || is_output[h] || consumers[h] != 1) continue;
+        const Node& c = p_nodes[consumer[h]];
+        fused[h] = (is_elementwise(c.op) && c.shape == n.shape) || c.op == SUM;
+    }
+
+    std::vector<Handle> roots;
+    p_steps.clear();
+    for (Handle h = 0; h < count; ++h) {
+        const Node& n = p_nodes[h];
+        if (!live[h] || n.op == INPUT || n.op == CONSTANT || fused[h]) continue;
+
+        Step step;
+        step.reduce = n.op == SUM;
+        step.shape = step.reduce ? node(n.args[0]).shape : n.shape;
+        step.total = step.shape.total();
+        step.target = FROM_BUFFER;
+        step.target_index = -1;
+        step.runs = 0;
+        step.seconds = 0.0;
+        if (!step.reduce) {
+            collect(h, fused, step.shape, step);
+        } else if (fused[n.args[0]]) {
+            collect(n.args[0], fused, step.shape, step);
+        } else {
+            step.stages.push_back(Stage{IDENTITY, {leaf(n.args[0], step.shape)}, 1});
+        }
+
+        for (std::size_t s = 0; s < step.stages.size(); ++s) {
+            step.name += (s ? "+" : "");
+            step.name += detail::op_name(step.stages[s].op);
+        }
+        if (step.reduce) step.name = "sum(" + step.name + ")";
+
+        roots.push_back(h);
+        p_steps.push_back(std::move(step));
+    }
+
+    // Last step reading every stored result
+    std::vector<arg_type> last_use(count, -1);
+    for (std::size_t s = 0; s < p_steps.size(); ++s) {
+        for (const Stage& stage : p_steps[s].stages) {
+            for (arg_type k = 0; k < stage.arity; ++k) {
+                if (stage.args[k].source == FROM_BUFFER) last_use[stage.args[k].index] = s;
+            }
+        }
+    }
+
+    // Lifetime-based buffer assignment: a buffer returns to the free list after its
+    // last reader and is reused by the best-fitting later result
+    p_location.assign(count, -1);
+    p_kind.assign(count, FROM_BUFFER);
+    std::vector<arg_type> sizes;
+    std::vector<arg_type> free_list;
+    std::vector<Handle> active;
+    for (std::size_t s = 0; s < p_steps.size(); ++s) {
+        for (auto it = active.begin(); it != active.end();) {
+            if (last_use[*it] < static_cast<arg_type>(s)) {
+                free_list.push_back(p_location[*it]);
+                it = active.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        const Handle root = roots[s];
+        Step& step = p_steps[s];
+        if (is_output[root]) {
+            p_kind[root] = FROM_OUTPUT;
+            p_location[root] = output_index[root];
+        } else {
+            const arg_type need = step.reduce ? 1 : step.total;
+            auto best = free_list.end();
+            for (auto it = free_list.begin(); it != free_list.end(); ++it) {
+                const bool fits = sizes[*it] >= need;
+                if (best == free_list.end()
+                    || (fits && (sizes[*best] < need || sizes[*it] < sizes[*best]))
+                    || (!fits && sizes[*best] < need && sizes[*it] > sizes[*best])) {
+                    best = it;
+                }
+            }
+            arg_type buffer;
+            if (best != free_list.end()) {
+                buffer = *best;
+                free_list.erase(best);
+                sizes[buffer] = std::max(sizes[buffer], need);
+            } else {
+                buffer = sizes.size();
+                sizes.push_back(need);
+            }
+            p_location[root] = buffer;
+            active.push_back(root);
+        }
+        step.target = p_kind[root];
+        step.target_index = p_location[root];
+    }
+
+    // Stored operands now know where their producer writes
+    for (Step& step : p_steps) {
+        for (Stage& stage : step.stages) {
+            for (arg_type k = 0; k < stage.arity; ++k) {
+                Operand& op = stage.args[k];
+                if (op.source != FROM_BUFFER) continue;
+                const Handle h = op.index;
+                op.source = p_kind[h];
+                op.index = p_location[h];
+            }
+        }
+    }
+
+    p_buffers.assign(sizes.size(), {});
+    for (std::size_t b = 0; b < sizes.size(); ++b) p_buffers[b].resize(sizes[b]);
+    p_results.clear();
+    for (Handle h : p_outputs) p_results.emplace_back(p_nodes[h].shape, T());
+
+    std::size_t max_stages = 1;
+    for (const Step& step : p_steps) max_stages = std::max(max_stages, step.stages.size());
+    const arg_type threads = Parallel::ThreadPool::instance().size();
+    p_scratch_stride = (max_stages + 3) * detail::PLAN_BLOCK;
+    p_scratch.assign(p_scratch_stride * threads, T());
+    p_partial.assign(threads, T());
+    p_compiled = true;
+}
+
+template <typename T>
+bool
+Plan<T>::compiled() const
+{
+    return p_compiled;
+}
+
+// ----------------- REPLAY -----------------
+
+template <typename T>
+const T*
+Plan<T>::source_data(Source source, arg_type index) const
+{
+    switch (source) {
+        case FROM_INPUT:  return p_inputs[index]->data();
+        case FROM_BUFFER: return p_buffers[index].data();
+        case FROM_OUTPUT: return p_results[index].data();
+        default:          return nullptr;
+    }
+}
+
+template <typename T>
+void
+Plan<T>::execute(Step& step)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const arg_type stages = step.stages.size();
+    const arg_type grain = std::max<arg_type>(detail::PLAN_BLOCK, Parallel::DEFAULT_GRAIN / stages);
+    const arg_type chunks = Parallel::chunk_count(step.total, grain);
+    T* target = const_cast<T*>(source_data(step.target, step.target_index));
+
+    Parallel::parallel_chunks(0, step.total, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+        T* scratch = p_scratch.data() + chunk * p_scratch_stride;
+        T* slots = scratch + p_scratch_stride - 3 * detail::PLAN_BLOCK;
+        T acc = T(0);
+
+        for (arg_type blk = b; blk < e; blk += detail::PLAN_BLOCK) {
+            const arg_type n = std::min(detail::PLAN_BLOCK, e - blk);
+            for (arg_type s = 0; s < stages; ++s) {
+                const Stage& stage = step.stages[s];
+                const bool root = s + 1 == stages;
+                T* out = (root && !step.reduce) ? target + blk : scratch + s * detail::PLAN_BLOCK;
+
+                const T* in[3] = {nullptr, nullptr, nullptr};
+                for (arg_type k = 0; k < stage.arity; ++k) {
+                    const Operand& op = stage.args[k];
+                    T* slot = slots + k * detail::PLAN_BLOCK;
+                    if (op.source == FROM_STAGE) {
+                        in[k] = scratch + op.index * detail::PLAN_BLOCK;
+                    } else if (op.source == FROM_CONSTANT) {
+                        std::fill(slot, slot + n, op.value);
+                        in[k] = slot;
+                    } else if (op.contiguous) {
+                        in[k] = source_data(op.source, op.index) + blk;
+                    } else {
+                        detail::gather(source_data(op.source, op.index), step.shape, op.strides, blk, n, slot);
+                        in[k] = slot;
+                    }
+                }
+                detail::apply(stage.op, in, out, n);
+                if (root && step.reduce) {
+                    for (arg_type i = 0; i < n; ++i) acc += out[i];
+                }
+            }
+        }
+        if (step.reduce) p_partial[chunk] = acc;
+    });
+
+    if (step.reduce) {
+        T total = T(0);
+        for (arg_type c = 0; c < chunks; ++c) total += p_partial[c];
+        target[0] = total;
+    }
+
+    ++step.runs;
+    step.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+void
+Plan<T>::run(const Array<T>* const* inputs, arg_type count)
+{
+    if (!p_compiled) compile();
+    if (count != static_cast<arg_type>(p_input_shapes.size())) {
+        throw std::invalid_argument("Plan::Wrong number of inputs");
+    }
+    for (arg_type i = 0; i < count; ++i) {
+        if (inputs[i]->shape() != p_input_shapes[i]) {
+            throw std::invalid_argument("Plan::Input shape doesn't match the recorded shape");
+        }
+    }
+
+    p_inputs = inputs;
+    for (Step& step : p_steps) execute(step);
+    p_inputs = nullptr;
+}
+
+template <typename T>
+template <typename... Arrays>
+void
+Plan<T>::run(const Arrays&... inputs)
+{
+    const std::array<const Array<T>*, sizeof...(Arrays)> pointers{&inputs...};
+    run(pointers.data(), static_cast<arg_type>(pointers.size()));
+}
+
+template <typename T>
+const Array<T>&
+Plan<T>::result(arg_type index) const
+{
+    if (!p_compiled) throw std::runtime_error("Plan::Not compiled");
+    if (index < 0 || index >= static_cast<arg_type>(p_results.size())) {
+        throw std::out_of_range("Plan::Output index out of range");
+    }
+    return p_results[index];
+}
+
+template <typename T>
+arg_type
+Plan<T>::step_count() const
+{
+    return p_steps.size();
+}
+
+template <typename T>
+arg_type
+Plan<T>::buffer_count() const
+{
+    return p_buffers.size();
+}
+
+// ----------------- TIMING -----------------
+
+template <typename T>
+std::vector<StageTiming>
+Plan<T>::timings() const
+{
+    std::vector<StageTiming> res;
+    for (const Step& step : p_steps) res.push_back(StageTiming{step.name, step.runs, step.seconds * 1e3});
+    return res;
+}
+
+template <typename T>
+void
+Plan<T>::reset_timings()
+{
+    for (Step& step : p_steps) {
+        step.runs = 0;
+        step.seconds = 0.0;
+    }
+}
+
+template <typename T>
+void
+Plan<T>::print_timings() const
+{
+    for (const Step& step : p_steps) {
+        const double mean_us = step.runs ? step.seconds * 1e6 / step.runs : 0.0;
+        std::cout << step.name << ": " << step.runs << " runs, "
+                  << step.seconds * 1e3 << " ms total, " << mean_us << " us per run\n";
+    }
+}
+
+}
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace SamH::NumC::Global
+{
+
+namespace detail
+{
+    // Neighbouring columns slid together by one task when the axis isn't the last one
+    constexpr arg_type ROLLING_LANES = 16;
+
+    // Floating types, half precision included, take the compensated paths below
+    template <typename T>
+    constexpr bool rolling_floating = std::is_floating_point_v<T> || NumC::detail::is_half_v<T>;
+
+    // Accumulator of rolling sums: double for floating types (long double kept), 64-bit
+    // for integers
+    template <typename T>
+    using rolling_sum_type = std::conditional_t<std::is_same_v<T, long double>, long double,
+                             std::conditional_t<rolling_floating<T>, double,
+                             std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>>;
+
+    // s + c is the running sum, c collects the low-order bits every addition to s drops
+    template <typename A>
+    inline void neumaier_add(A& s, A& c, A x)
+    {
+        const A t = s + x;
+        c += std::abs(s) >= std::abs(x) ? (s - t) + x : (x - t) + s;
+        s = t;
+    }
+
+    // Exact difference: a - b == d + e
+    template <typename A>
+    inline void two_difference(A a, A b, A& d, A& e)
+    {
+        d = a - b;
+        const A shift = d - a;
+        e = (a - (d - shift)) - (b + shift);
+    }
+
+    // Every kernel below fills result positions [kb, ke) for `lanes` adjacent columns;
+    // position k of column l is at src[k * stride + l] and dst[k * stride + l]. Lanes is
+    // arg_type, or a constant for the common single-column case.
+
+    // finish(sum) for every window
+    template <typename T, typename R, typename Lanes, typename Finish>
+    void rolling_sum_block(const T* src, R* dst, arg_type stride, Lanes lanes,
+                           arg_type window, arg_type kb, arg_type ke, Finish finish)
+    {
+        using A = rolling_sum_type<T>;
+        A s[ROLLING_LANES] = {};
+        A c[ROLLING_LANES] = {};
+
+        auto emit = [&](arg_type k) {
+            R* out = dst + k * stride;
+            for (arg_type l = 0; l < lanes; ++l) out[l] = finish(s[l] + c[l]);
+        };
+
+        for (arg_type i = kb; i < kb + window; ++i) {
+            const T* in = src + i * stride;
+            for (arg_type l = 0; l < lanes; ++l) {
+                if constexpr (rolling_floating<T>) neumaier_add(s[l], c[l], static_cast<A>(in[l]));
+                else                               s[l] += static_cast<A>(in[l]);
+            }
+        }
+        emit(kb);
+
+        for (arg_type k = kb + 1; k < ke; ++k) {
+            const T* in = src + (k + window - 1) * stride;
+            const T* old = src + (k - 1) * stride;
+            for (arg_type l = 0; l < lanes; ++l) {
+                if constexpr (rolling_floating<T>) {
+                    // One compensated step per slide: the entering minus the leaving value,
+                    // with the rounding of that difference folded into c
+                    A d, e;
+                    two_difference(static_cast<A>(in[l]), static_cast<A>(old[l]), d, e);
+                    neumaier_add(s[l], c[l], d);
+                    c[l] += e;
+                } else {
+                    s[l] += static_cast<A>(in[l]) - static_cast<A>(old[l]);
+                }
+            }
+            emit(k);
+        }
+    }
+
+    // Variance (or standard deviation) of every window, sum of squared deviations / divisor
+    template <typename T, typename Lanes>
+    void rolling_moments_block(const T* src, double* dst, arg_type stride, Lanes lanes,
+                               arg_type window, arg_type kb, arg_type ke, double divisor, bool root)
+    {
+        double mean[ROLLING_LANES] = {};
+        double m2[ROLLING_LANES] = {};
+
+        auto emit = [&](arg_type k) {
+            double* out = dst + k * stride;
+            for (arg_type l = 0; l < lanes; ++l) {
+                const double v = divisor > 0 ? std::max(m2[l], 0.0) / divisor
+                                             : std::numeric_limits<double>::quiet_NaN();
+                out[l] = root ? std::sqrt(v) : v;
+            }
+        };
+
+        // Values are taken relative to the piece's first one, so the updates below work
+        // on deviations rather than on large magnitudes whose rounding would accumulate
+        double shift[ROLLING_LANES] = {};
+        for (arg_type l = 0; l < lanes; ++l) shift[l] = static_cast<double>(src[kb * stride + l]);
+
+        for (arg_type i = kb; i < kb + window; ++i) {
+            const T* in = src + i * stride;
+            const double n = static_cast<double>(i - kb + 1);
+            for (arg_type l = 0; l < lanes; ++l) {
+                const double x = static_cast<double>(in[l]) - shift[l];
+                const double d = x - mean[l];
+                mean[l] += d / n;
+                m2[l] += d * (x - mean[l]);
+            }
+        }
+        emit(kb);
+
+        // Replacing x_old by x_new keeps the count, so mean and m2 move by closed-form deltas
+        const double inv_w = 1.0 / static_cast<double>(window);
+        for (arg_type k = kb + 1; k < ke; ++k) {
+            const T* in = src + (k + window - 1) * stride;
+            const T* old = src + (k - 1) * stride;
+            for (arg_type l = 0; l < lanes; ++l) {
+                const double x_new = static_cast<double>(in[l]) - shift[l];
+                const double x_old = static_cast<double>(old[l]) - shift[l];
+                const double d = x_new - x_old;
+                const double next = mean[l] + d * inv_w;
+                m2[l] += d * (x_new - next + x_old - mean[l]);
+                mean[l] = next;
+            }
+            emit(k);
+        }
+    }
+
+    // Minimum (or maximum) of every window. Each column keeps a ring of candidate
+    // (position, value) pairs with values in order from the front: a new value drops
+    // every candidate it beats from the back, the front leaves once it falls out.
+    template <typename T, typename Lanes, typename Before>
+    void rolling_extreme_block(const T* src, T* dst, arg_type stride, Lanes lanes,
+                               arg_type window, arg_type kb, arg_type ke, Before before)
+    {
+        std::vector<arg_type> positions(lanes * window);
+        std::vector<T> values(lanes * window);
+        arg_type front[ROLLING_LANES] = {};
+        arg_type count[ROLLING_LANES] = {};
+
+        for (arg_type i = kb; i < ke + window - 1; ++i) {
+            const T* in = src + i * stride;
+            for (arg_type l = 0; l < lanes; ++l) {
+                arg_type* pos = positions.data() + l * window;
+                T* val = values.data() + l * window;
+                if (count[l] > 0 && pos[front[l]] <= i - window) {
+                    front[l] = front[l] + 1 == window ? 0 : front[l] + 1;
+                    --count[l];
+                }
+                const T x = in[l];
+                arg_type slot = front[l] + count[l];
+                if (slot >= window) slot -= window;
+                while (count[l] > 0) {
+                    const arg_type back = slot == 0 ? window - 1 : slot - 1;
+                    if (before(val[back], x)) break;
+                    slot = back;
+                    --count[l];
+                }
+                pos[slot] = i;
+                val[slot] = x;
+                ++count[l];
+            }
+            if (i >= kb + window - 1) {
+                T* out = dst + (i - window + 1) * stride;
+                for (arg_type l = 0; l < lanes; ++l) out[l] = values[l * window + front[l]];
+            }
+        }
+    }
+
+    // Runs kernel(src, dst, stride, lanes, kb, ke) over every (outer row, column block,
+    // piece of the axis) and returns the result with the axis shrunk to len - window + 1
+    template <typename R, typename T, typename Kernel>
+    Array<R> rolling_apply(const Array<T>& arr, arg_type window, arg_type axis, Kernel kernel)
+    {
+        arg_type outer, len, inner;
+        split_axis(arr.shape(), axis, outer, len, inner);
+        if (window < 1 || window > len) {
+            throw std::invalid_argument("rolling::Window must be between 1 and the axis length");
+        }
+
+        const arg_type count = len - window + 1;
+        Shape shape = arr.shape();
+        shape[axis] = count;
+        Array<R> res = Array<R>::uninitialized(shape);
+        if (res.size() == 0) return res;
+
+        // A piece re-reads window - 1 values before its first result, so pieces are
+        // kept at least a window long and only made when there are too few columns
+        const arg_type blocks = (inner + ROLLING_LANES - 1) / ROLLING_LANES;
+        const arg_type width = std::min(inner, ROLLING_LANES);
+        arg_type pieces = 1;
+        if (outer * blocks < Parallel::num_threads()) {
+            pieces = std::min(Parallel::chunk_count(count * width), std::max<arg_type>(1, count / window));
+        }
+        const arg_type tasks = outer * blocks * pieces;
+        const arg_type task_work = (count / pieces + window) * width;
+
+        const T* src = arr.data();
+        R* dst = res.data();
+        Parallel::parallel_for(0, tasks, [&](arg_type b, arg_type e) {
+            for (arg_type t = b; t < e; ++t) {
+                const arg_type piece = t % pieces;
+                const arg_type block = t / pieces % blocks;
+                const arg_type o = t / pieces / blocks;
+                const arg_type jb = block * ROLLING_LANES;
+                const arg_type kb = count * piece / pieces;
+                const arg_type ke = count * (piece + 1) / pieces;
+                const arg_type lanes = std::min(ROLLING_LANES, inner - jb);
+                if (lanes == 1) {
+                    kernel(src + o * len * inner + jb, dst + o * count * inner + jb, inner,
+                           std::integral_constant<arg_type, 1>(), kb, ke);
+                } else {
+                    kernel(src + o * len * inner + jb, dst + o * count * inner + jb, inner, lanes, kb, ke);
+                }
+            }
+        }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / task_work));
+        return res;
+    }
+}
+
+template <typename T>
+Array<T>
+rolling_sum(const Array<T>& arr, arg_type window, arg_type axis)
+{
+    return detail::rolling_apply<T>(arr, window, axis,
+        [window](const T* src, T* dst, arg_type stride, auto lanes, arg_type kb, arg_type ke) {
+            detail::rolling_sum_block(src, dst, stride, lanes, window, kb, ke,
+                                      [](auto sum) { return static_cast<T>(sum); });
+        });
+}
+
+template <typename T>
+Array<double>
+rolling_mean(const Array<T>& arr, arg_type window, arg_type axis)
+{
+    const double scale = 1.0 / static_cast<double>(window);
+    return detail::rolling_apply<double>(arr, window, axis,
+        [window, scale](const T* src, double* dst, arg_type stride, auto lanes, arg_type kb, arg_type ke) {
+            detail::rolling_sum_block(src, dst, stride, lanes, window, kb, ke,
+                                      [scale](auto sum) { return static_cast<double>(sum) * scale; });
+        });
+}
+
+template <typename T>
+Array<double>
+rolling_var(const Array<T>& arr, arg_type window, arg_type axis, arg_type ddof)
+{
+    const double divisor = static_cast<double>(window - ddof);
+    return detail::rolling_apply<double>(arr, window, axis,
+        [window, divisor](const T* src, double* dst, arg_type stride, auto lanes, arg_type kb, arg_type ke) {
+            detail::rolling_moments_block(src, dst, stride, lanes, window, kb, ke, divisor, false);
+        });
+}
+
+template <typename T>
+Array<double>
+rolling_std(const Array<T>& arr, arg_type window, arg_type axis, arg_type ddof)
+{
+    const double divisor = static_cast<double>(window - ddof);
+    return detail::rolling_apply<double>(arr, window, axis,
+        [window, divisor](const T* src, double* dst, arg_type stride, auto lanes, arg_type kb, arg_type ke) {
+            detail::rolling_moments_block(src, dst, stride, lanes, window, kb, ke, divisor, true);
+        });
+}
+
+template <typename T>
+Array<T>
+rolling_min(const Array<T>& arr, arg_type window, arg_type axis)
+{
+    return detail::rolling_apply<T>(arr, window, axis,
+        [window](const T* src, T* dst, arg_type stride, auto lanes, arg_type kb, arg_type ke) {
+            detail::rolling_extreme_block(src, dst, stride, lanes, window, kb, ke,
+                                          [](const T& a, const T& b) { return a < b; });
+        });
+}
+
+template <typename T>
+Array<T>
+rolling_max(const Array<T>& arr, arg_type window, arg_type axis)
+{
+    return detail::rolling_apply<T>(arr, window, axis,
+        [window](const T* src, T* dst, arg_type stride, auto lanes, arg_type kb, arg_type ke) {
+            detail::rolling_extreme_block(src, dst, stride, lanes, window, kb, ke,
+                                          [](const T& a, const T& b) { return b < a; });
+        });
+}
+
+}
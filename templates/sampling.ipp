@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace SamH::NumC::Random
+{
+
+namespace detail
+{
+    // Below this many elements shuffles run serially on the shared engine
+    constexpr arg_type SHUFFLE_SERIAL = arg_type(1) << 16;
+
+    // Independent per-chunk engine seeds, drawn from the shared engine
+    inline std::vector<std::uint64_t> chunk_seeds(arg_type chunks)
+    {
+        std::mt19937& eng = get_engine();
+        std::vector<std::uint64_t> seeds(chunks);
+        for (auto& seed : seeds) seed = (static_cast<std::uint64_t>(eng()) << 32) | eng();
+        return seeds;
+    }
+
+    // Uniform double in [0, 1) from the top 53 bits of one 64-bit draw
+    inline double unit(std::uint64_t bits)
+    {
+        return (bits >> 11) * 0x1.0p-53;
+    }
+
+    // out[i] = draw(engine, i) across the pool, one engine per chunk
+    template <typename U, typename Draw>
+    void fill_parallel(U* out, arg_type count, Draw&& draw)
+    {
+        const arg_type chunks = Parallel::chunk_count(count);
+        const std::vector<std::uint64_t> seeds = chunk_seeds(chunks);
+        Parallel::parallel_chunks(0, count, chunks, [&](arg_type c, arg_type b, arg_type e) {
+            std::mt19937_64 engine(seeds[c]);
+            for (arg_type i = b; i < e; ++i) out[i] = draw(engine, i);
+        });
+    }
+
+    template <typename T, typename Engine>
+    void fisher_yates(T* data, arg_type n, Engine& engine)
+    {
+        for (arg_type i = n - 1; i > 0; --i) {
+            std::uniform_int_distribution<arg_type> dist(0, i);
+            std::swap(data[i], data[dist(engine)]);
+        }
+    }
+
+    inline void check_weights(const std::vector<double>& weights)
+    {
+        double total = 0.0;
+        for (double w : weights) {
+            if (!(w >= 0.0) || std::isinf(w)) throw std::invalid_argument("Random::Weights must be finite and non-negative");
+            total += w;
+        }
+        if (!(total > 0.0)) throw std::invalid_argument("Random::Weights must have a positive sum");
+    }
+}
+
+// ----------------- ALIAS TABLE -----------------
+
+inline
+AliasTable::AliasTable(const std::vector<double>& weights)
+{
+    build(weights);
+}
+
+template <typename T>
+AliasTable::AliasTable(const Array<T>& weights)
+{
+    build(std::vector<double>(weights.data(), weights.data() + weights.size()));
+}
+
+inline void
+AliasTable::build(std::vector<double> weights)
+{
+    detail::check_weights(weights);
+    const arg_type n = weights.size();
+    const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+    // Scaled so the average bucket holds exactly 1; small buckets are topped up from large ones
+    a_threshold.assign(n, 1.0);
+    a_alias.resize(n);
+    std::iota(a_alias.begin(), a_alias.end(), arg_type(0));
+    std::vector<arg_type> small;
+    std::vector<arg_type> large;
+    for (arg_type i = 0; i < n; ++i) {
+        weights[i] *= n / total;
+        (weights[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        const arg_type s = small.back();
+        const arg_type l = large.back();
+        small.pop_back();
+        a_threshold[s] = weights[s];
+        a_alias[s] = l;
+        weights[l] -= 1.0 - weights[s];
+        if (weights[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Whatever is left is 1 up to rounding and keeps its own index
+}
+
+inline arg_type
+AliasTable::size() const
+{
+    return a_threshold.size();
+}
+
+template <typename Engine>
+arg_type
+AliasTable::operator()(Engine& engine) const
+{
+    const double u = std::uniform_real_distribution<double>(0.0, static_cast<double>(size()))(engine);
+    const arg_type bucket = std::min(static_cast<arg_type>(u), size() - 1);
+    return u - bucket < a_threshold[bucket] ? bucket : a_alias[bucket];
+}
+
+inline void
+AliasTable::sample(arg_type* out, arg_type count) const
+{
+    if (size() == 0) throw std::logic_error("Random::AliasTable is empty");
+    const double n = static_cast<double>(size());
+    detail::fill_parallel(out, count, [&](std::mt19937_64& engine, arg_type) {
+        const double u = detail::unit(engine()) * n;
+        const arg_type bucket = std::min(static_cast<arg_type>(u), size() - 1);
+        return u - bucket < a_threshold[bucket] ? bucket : a_alias[bucket];
+    });
+}
+
+inline Array<arg_type>
+AliasTable::sample(arg_type count) const
+{
+    Array<arg_type> res = Array<arg_type>::uninitialized(Shape{count});
+    sample(res.data(), count);
+    return res;
+}
+
+// ----------------- WITHOUT REPLACEMENT -----------------
+
+inline Array<arg_type>
+sample_indices(arg_type n, arg_type k)
+{
+    if (k < 0 || k > n) throw std::invalid_argument("Random::Can't take a larger sample than the population");
+    Array<arg_type> res = Array<arg_type>::uninitialized(Shape{k});
+    arg_type* out = res.data();
+    std::mt19937& eng = get_engine();
+
+    if (k * 8 >= n) {
+        std::vector<arg_type> pool(n);
+        std::iota(pool.begin(), pool.end(), arg_type(0));
+        for (arg_type i = 0; i < k; ++i) {
+            std::uniform_int_distribution<arg_type> dist(i, n - 1);
+            std::swap(pool[i], pool[dist(eng)]);
+        }
+        std::copy(pool.begin(), pool.begin() + k, out);
+        return res;
+    }
+
+    // Floyd: every step adds exactly one new index, so only k draws and a k-sized set
+    std::unordered_set<arg_type> taken;
+    taken.reserve(2 * k);
+    arg_type filled = 0;
+    for (arg_type j = n - k; j < n; ++j) {
+        const arg_type t = std::uniform_int_distribution<arg_type>(0, j)(eng);
+        const arg_type pick = taken.insert(t).second ? t : j;
+        if (pick == j) taken.insert(j);
+        out[filled++] = pick;
+    }
+    // Floyd's order is biased towards late picks being large, shuffle for a random order
+    detail::fisher_yates(out, k, eng);
+    return res;
+}
+
+inline Array<arg_type>
+sample_indices(const std::vector<double>& weights, arg_type k)
+{
+    detail::check_weights(weights);
+    const arg_type n = weights.size();
+    const arg_type positive = std::count_if(weights.begin(), weights.end(), [](double w) { return w > 0.0; });
+    if (k < 0 || k > positive) throw std::invalid_argument("Random::Can't take a larger sample than the population");
+
+    // The k largest log(u) / w keys, in decreasing order, are a weighted sample in draw order
+    std::vector<std::pair<double, arg_type>> keys(n);
+    detail::fill_parallel(keys.data(), n, [&](std::mt19937_64& engine, arg_type i) {
+        const double key = std::log(1.0 - detail::unit(engine()));
+        return std::pair<double, arg_type>(weights[i] > 0.0 ? key / weights[i] : -HUGE_VAL, i);
+    });
+    auto larger = [](const auto& x, const auto& y) { return x.first > y.first; };
+    std::nth_element(keys.begin(), keys.begin() + std::min(k, n - 1), keys.end(), larger);
+    std::sort(keys.begin(), keys.begin() + k, larger);
+
+    Array<arg_type> res = Array<arg_type>::uninitialized(Shape{k});
+    for (arg_type i = 0; i < k; ++i) res.data()[i] = keys[i].second;
+    return res;
+}
+
+// ----------------- RESERVOIR -----------------
+
+template <typename T>
+Reservoir<T>::Reservoir(arg_type capacity)
+    : r_capacity(std::max<arg_type>(0, capacity))
+    , r_engine(detail::chunk_seeds(1)[0])
+{
+    r_items.reserve(r_capacity);
+}
+
+template <typename T>
+void
+Reservoir<T>::advance()
+{
+    // Skip ahead by the geometric number of values that don't make it in
+    const double u = 1.0 - detail::unit(r_engine());
+    r_next += static_cast<arg_type>(std::floor(std::log(u) / std::log1p(-r_weight)));
+    r_weight *= std::exp(std::log(1.0 - detail::unit(r_engine())) / r_capacity);
+}
+
+template <typename T>
+void
+Reservoir<T>::add(const T* values, arg_type count)
+{
+    if (r_capacity == 0) {
+        r_seen += count;
+        return;
+    }
+    arg_type i = 0;
+    while (i < count && static_cast<arg_type>(r_items.size()) < r_capacity) {
+        r_items.push_back(values[i++]);
+        if (static_cast<arg_type>(r_items.size()) == r_capacity) {
+            r_weight = std::exp(std::log(1.0 - detail::unit(r_engine())) / r_capacity);
+            r_next = r_seen + i;
+            advance();
+        }
+    }
+
+    const arg_type base = r_seen;
+    const arg_type end = base + count;
+    while (static_cast<arg_type>(r_items.size()) == r_capacity && r_next < end) {
+        const arg_type slot = std::uniform_int_distribution<arg_type>(0, r_capacity - 1)(r_engine);
+        r_items[slot] = values[r_next - base];
+        ++r_next;
+        advance();
+    }
+    r_seen = end;
+}
+
+template <typename T>
+void
+Reservoir<T>::add(const T& value)
+{
+    add(&value, 1);
+}
+
+template <typename T>
+void
+Reservoir<T>::add(const Array<T>& chunk)
+{
+    add(chunk.data(), chunk.size());
+}
+
+template <typename T>
+arg_type
+Reservoir<T>::capacity() const
+{
+    return r_capacity;
+}
+
+template <typename T>
+arg_type
+Reservoir<T>::seen() const
+{
+    return r_seen;
+}
+
+template <typename T>
+Array<T>
+Reservoir<T>::sample() const
+{
+    return Array<T>(r_items);
+}
+
+// ----------------- SHUFFLE -----------------
+
+template <typename T>
+void
+shuffle(Array<T>& arr)
+{
+    const arg_type n = arr.size();
+    T* data = arr.data();
+    const arg_type chunks = Parallel::chunk_count(n);
+    if (n < detail::SHUFFLE_SERIAL || chunks == 1) {
+        detail::fisher_yates(data, n, get_engine());
+        return;
+    }
+
+    // Every element picks a bucket, buckets are laid out back to back and each one is
+    // shuffled on its own; with uniform buckets and uniform shuffles the result is uniform
+    const arg_type buckets = chunks;
+    const std::vector<std::uint64_t> seeds = detail::chunk_seeds(chunks + buckets);
+    std::vector<std::uint16_t> bucket_of(n);
+    std::vector<arg_type> position(chunks * buckets, 0);
+
+    Parallel::parallel_chunks(0, n, chunks, [&](arg_type c, arg_type b, arg_type e) {
+        std::mt19937_64 engine(seeds[c]);
+        arg_type* counts = position.data() + c * buckets;
+        for (arg_type i = b; i < e; ++i) {
+            const auto k = static_cast<std::uint16_t>((static_cast<unsigned __int128>(engine()) * buckets) >> 64);
+            bucket_of[i] = k;
+            ++counts[k];
+        }
+    });
+
+    std::vector<arg_type> bucket_start(buckets + 1, 0);
+    for (arg_type k = 0, offset = 0; k < buckets; ++k) {
+        bucket_start[k] = offset;
+        for (arg_type c = 0; c < chunks; ++c) {
+            const arg_type count = position[c * buckets + k];
+            position[c * buckets + k] = offset;
+            offset += count;
+        }
+        bucket_start[k + 1] = offset;
+    }
+
+    std::vector<T> scattered(n);
+    Parallel::parallel_chunks(0, n, chunks, [&](arg_type c, arg_type b, arg_type e) {
+        arg_type* next = position.data() + c * buckets;
+        for (arg_type i = b; i < e; ++i) scattered[next[bucket_of[i]]++] = std::move(data[i]);
+    });
+
+    Parallel::parallel_for(0, buckets, [&](arg_type b, arg_type e) {
+        for (arg_type k = b; k < e; ++k) {
+            std::mt19937_64 engine(seeds[chunks + k]);
+            T* first = scattered.data() + bucket_start[k];
+            const arg_type count = bucket_start[k + 1] - bucket_start[k];
+            detail::fisher_yates(first, count, engine);
+            std::move(first, first + count, data + bucket_start[k]);
+        }
+    }, 1);
+}
+
+template <typename T>
+Array<T>
+permutation(const Array<T>& arr)
+{
+    Array<T> result = arr;
+    shuffle(result);
+    return result;
+}
+
+inline Array<arg_type>
+permutation(arg_type n)
+{
+    Array<arg_type> result = Array<arg_type>::uninitialized(Shape{n});
+    std::iota(result.data(), result.data() + n, arg_type(0));
+    shuffle(result);
+    return result;
+}
+
+// ----------------- CHOICE -----------------
+
+template <typename T>
+Array<T>
+choice(const std::vector<T>& a, const std::vector<arg_type>& size, bool replace)
+{
+    if (a.empty()) throw std::invalid_argument("Random::choice from an empty population");
+    const arg_type total = compute_total(size);
+    Array<T> result = Array<T>::uninitialized(Shape(size));
+    T* out = result.data();
+
+    if (replace) {
+        const arg_type n = a.size();
+        detail::fill_parallel(out, total, [&](std::mt19937_64& engine, arg_type) {
+            return a[static_cast<arg_type>((static_cast<unsigned __int128>(engine()) * n) >> 64)];
+        });
+    } else {
+        const Array<arg_type> picks = sample_indices(a.size(), total);
+        for (arg_type i = 0; i < total; ++i) out[i] = a[picks.data()[i]];
+    }
+    return result;
+}
+
+template <typename T>
+Array<T>
+choice(const std::vector<T>& a, const std::vector<arg_type>& size, const std::vector<double>& p, bool replace)
+{
+    if (a.empty()) throw std::invalid_argument("Random::choice from an empty population");
+    if (p.size() != a.size()) throw std::invalid_argument("Random::choice needs one probability per element");
+    const arg_type total = compute_total(size);
+    Array<T> result = Array<T>::uninitialized(Shape(size));
+    T* out = result.data();
+
+    const Array<arg_type> picks = replace ? AliasTable(p).sample(total) : sample_indices(p, total);
+    Parallel::parallel_for(0, total, [&](arg_type b, arg_type e) {
+        for (arg_type i = b; i < e; ++i) out[i] = a[picks.data()[i]];
+    });
+    return result;
+}
+
+inline Array<int>
+choice(const std::vector<int>& a, const std::vector<arg_type>& size, bool replace)
+{
+    return choice<int>(a, size, replace);
+}
+
+inline Array<int>
+choice(const std::vector<int>& a, const std::vector<arg_type>& size, const std::vector<double>& p, bool replace)
+{
+    return choice<int>(a, size, p, replace);
+}
+
+}
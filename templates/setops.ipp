@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace SamH::NumC::Global
+{
+
+namespace detail
+{
+    // Integer test sets become bitmaps while they span at most this many bits per
+    // value, or SET_BITMAP_MIN bits whatever their size
+    constexpr arg_type SET_BITMAP_BITS = 64;
+    constexpr arg_type SET_BITMAP_MIN = arg_type(1) << 20;
+    // Hash sets from this size on are probed through a Bloom filter first; by then the
+    // table has outgrown the caches and most misses never touch it
+    constexpr arg_type SET_BLOOM_MIN = arg_type(1) << 14;
+    // Flags per vector<bool> word; tasks writing a Mask start on multiples of it
+    constexpr arg_type MASK_WORD = 64;
+
+    template <typename T>
+    bool value_less(const T& a, const T& b)
+    {
+        return key_less(&a, &b, 1);
+    }
+
+    // Runs block(b, e) over the flags of res across the pool, never splitting a word
+    template <typename F>
+    void fill_mask(Mask& res, F block)
+    {
+        const arg_type n = res.size();
+        const arg_type words = (n + MASK_WORD - 1) / MASK_WORD;
+        Parallel::parallel_for(0, words, [&](arg_type wb, arg_type we) {
+            block(wb * MASK_WORD, std::min(we * MASK_WORD, n));
+        }, std::max<arg_type>(1, Parallel::DEFAULT_GRAIN / MASK_WORD));
+    }
+
+    // Non-decreasing, or increasing when strict
+    template <typename T>
+    bool is_sorted_values(const T* values, arg_type n, bool strict)
+    {
+        const arg_type chunks = Parallel::chunk_count(n);
+        std::vector<char> sorted(std::max<arg_type>(1, chunks), 1);
+        Parallel::parallel_chunks(0, n, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+            for (arg_type i = std::max<arg_type>(b, 1); i < e; ++i) {
+                if (strict ? !value_less(values[i - 1], values[i]) : value_less(values[i], values[i - 1])) {
+                    sorted[chunk] = 0;
+                    return;
+                }
+            }
+        });
+        return std::all_of(sorted.begin(), sorted.end(), [](char s) { return s != 0; });
+    }
+
+    // One 64-bit word per key, four bits set in it: a probe is a single load, and about
+    // 16 bits per key keep false positives near one in a hundred
+    class BloomFilter
+    {
+    public:
+        explicit BloomFilter(arg_type count)
+        {
+            std::size_t words = 64;
+            while (words * 4 < static_cast<std::size_t>(count)) words *= 2;
+            b_words.assign(words, 0);
+            b_shift = 64;
+            for (std::size_t w = words; w > 1; w >>= 1) --b_shift;
+        }
+
+        void add(std::uint64_t hash) { b_words[hash >> b_shift] |= bits(hash); }
+
+        bool may_contain(std::uint64_t hash) const
+        {
+            const std::uint64_t want = bits(hash);
+            return (b_words[hash >> b_shift] & want) == want;
+        }
+
+        void prefetch(std::uint64_t hash) const { __builtin_prefetch(b_words.data() + (hash >> b_shift)); }
+
+    private:
+        static std::uint64_t bits(std::uint64_t hash)
+        {
+            return (std::uint64_t(1) << (hash & 63)) | (std::uint64_t(1) << ((hash >> 6) & 63))
+                 | (std::uint64_t(1) << ((hash >> 12) & 63)) | (std::uint64_t(1) << ((hash >> 18) & 63));
+        }
+
+    private:
+        std::vector<std::uint64_t> b_words;
+        int b_shift;
+    };
+
+    // Membership of every element, through a bitmap over [low, low + span]
+    template <typename T>
+    void probe_bitmap(const T* src, const T* set, arg_type m, T low, std::uint64_t span, bool invert, Mask& res)
+    {
+        std::vector<std::uint64_t> bitmap(span / 64 + 1, 0);
+        for (arg_type j = 0; j < m; ++j) {
+            const std::uint64_t offset = static_cast<std::uint64_t>(set[j]) - static_cast<std::uint64_t>(low);
+            bitmap[offset >> 6] |= std::uint64_t(1) << (offset & 63);
+        }
+        fill_mask(res, [&](arg_type b, arg_type e) {
+            auto out = res.data.begin() + b;
+            for (arg_type i = b; i < e; ++i, ++out) {
+                const std::uint64_t offset = static_cast<std::uint64_t>(src[i]) - static_cast<std::uint64_t>(low);
+                const bool hit = offset <= span && ((bitmap[offset >> 6] >> (offset & 63)) & 1);
+                *out = hit != invert;
+            }
+        });
+    }
+
+    // Both sides sorted: every task finds its first element in set by binary search
+    // and walks on from there
+    template <typename T>
+    void probe_sorted(const T* src, const T* set, arg_type m, bool invert, Mask& res)
+    {
+        fill_mask(res, [&](arg_type b, arg_type e) {
+            const T* cursor = std::lower_bound(set, set + m, src[b], value_less<T>);
+            auto out = res.data.begin() + b;
+            for (arg_type i = b; i < e; ++i, ++out) {
+                while (cursor != set + m && value_less(*cursor, src[i])) ++cursor;
+                const bool hit = cursor != set + m && key_equal(*cursor, src[i]);
+                *out = hit != invert;
+            }
+        });
+    }
+
+    template <typename T>
+    void probe_hash(const T* src, const T* set, arg_type m, bool invert, Mask& res)
+    {
+        KeyTable<T> table(1, m);
+        for (arg_type j = 0; j < m; ++j) {
+            bool inserted;
+            table.insert(set + j, hash_key(set + j, 1), inserted);
+        }
+        const bool filtered = table.size() >= SET_BLOOM_MIN;
+        BloomFilter bloom(filtered ? table.size() : 0);
+        if (filtered) {
+            for (arg_type g = 0; g < table.size(); ++g) bloom.add(table.hash(g));
+        }
+
+        fill_mask(res, [&](arg_type b, arg_type e) {
+            std::uint64_t hashes[GROUP_BATCH];
+            auto out = res.data.begin() + b;
+            for (arg_type i = b; i < e; i += GROUP_BATCH) {
+                const arg_type count = std::min(GROUP_BATCH, e - i);
+                for (arg_type j = 0; j < count; ++j) {
+                    hashes[j] = hash_key(src + i + j, 1);
+                    if (filtered) bloom.prefetch(hashes[j]);
+                    else          table.prefetch(hashes[j]);
+                }
+                for (arg_type j = 0; j < count; ++j, ++out) {
+                    const bool hit = (!filtered || bloom.may_contain(hashes[j])) && table.find(src + i + j, hashes[j]) >= 0;
+                    *out = hit != invert;
+                }
+            }
+        });
+    }
+
+    // Sorted distinct values, the input itself when it already is
+    template <typename T>
+    Array<T> distinct_sorted(const Array<T>& arr)
+    {
+        if (!is_sorted_values(arr.data(), arr.size(), true)) return Global::group_count(arr).keys;
+        Array<T> res = Array<T>::uninitialized(Shape{arr.size()});
+        std::copy(arr.begin(), arr.end(), res.begin());
+        return res;
+    }
+}
+
+// ----------------- MEMBERSHIP -----------------
+
+template <typename T>
+Mask
+isin(const Array<T>& arr, const Array<T>& test, bool invert)
+{
+    const arg_type n = arr.size();
+    const arg_type m = test.size();
+    const T* src = arr.data();
+    const T* set = test.data();
+    Mask res(n);
+    if (n == 0) return res;
+    if (m == 0) {
+        if (invert) res.data.assign(n, true);
+        return res;
+    }
+
+    if constexpr (std::is_integral_v<T>) {
+        const auto [low, high] = std::minmax_element(set, set + m);
+        const std::uint64_t span = static_cast<std::uint64_t>(*high) - static_cast<std::uint64_t>(*low);
+        if (span < static_cast<std::uint64_t>(std::max(m * detail::SET_BITMAP_BITS, detail::SET_BITMAP_MIN))) {
+            detail::probe_bitmap(src, set, m, *low, span, invert, res);
+            return res;
+        }
+    }
+    if (detail::is_sorted_values(set, m, false) && detail::is_sorted_values(src, n, false)) {
+        detail::probe_sorted(src, set, m, invert, res);
+        return res;
+    }
+    detail::probe_hash(src, set, m, invert, res);
+    return res;
+}
+
+template <typename T>
+Mask
+in1d(const Array<T>& arr, const Array<T>& test, bool invert)
+{
+    return isin(arr, test, invert);
+}
+
+// ----------------- SET OPERATIONS -----------------
+
+template <typename T>
+Array<T>
+intersect1d(const Array<T>& a, const Array<T>& b)
+{
+    const Array<T> distinct = detail::distinct_sorted(a);
+    const Mask found = isin(distinct, b);
+    std::vector<T> res;
+    for (arg_type i = 0; i < distinct.size(); ++i) {
+        if (found[i]) res.push_back(distinct.data()[i]);
+    }
+    return Array<T>(res);
+}
+
+template <typename T>
+Array<T>
+union1d(const Array<T>& a, const Array<T>& b)
+{
+    const Array<T> first = detail::distinct_sorted(a);
+    const Array<T> second = detail::distinct_sorted(b);
+    std::vector<T> res;
+    res.reserve(first.size() + second.size());
+    std::set_union(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(res),
+                   detail::value_less<T>);
+    return Array<T>(res);
+}
+
+template <typename T>
+Array<T>
+setdiff1d(const Array<T>& a, const Array<T>& b)
+{
+    const Array<T> distinct = detail::distinct_sorted(a);
+    const Mask found = isin(distinct, b);
+    std::vector<T> res;
+    for (arg_type i = 0; i < distinct.size(); ++i) {
+        if (!found[i]) res.push_back(distinct.data()[i]);
+    }
+    return Array<T>(res);
+}
+
+}
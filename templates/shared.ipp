@@ -0,0 +1,810 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace SamH::NumC::Shared
+{
+
+namespace detail
+{
+    constexpr char ARRAY_MAGIC[8] = {'N', 'U', 'M', 'C', 'S', 'H', 'M', '1'};
+    constexpr char RING_MAGIC[8]  = {'N', 'U', 'M', 'C', 'R', 'N', 'G', '1'};
+    // Bytes per task when copying into or out of a segment
+    constexpr arg_type COPY_GRAIN = arg_type(1) << 20;
+    // Polls of an empty or full ring before a waiting thread goes to sleep
+    constexpr int SPIN_LIMIT = 64;
+
+    inline std::size_t align_up(std::size_t bytes)
+    {
+        return (bytes + STORAGE_ALIGNMENT - 1) / STORAGE_ALIGNMENT * STORAGE_ALIGNMENT;
+    }
+
+    inline void copy_bytes(void* dst, const void* src, std::size_t bytes)
+    {
+        char* out = static_cast<char*>(dst);
+        const char* in = static_cast<const char*>(src);
+        Parallel::parallel_for(0, static_cast<arg_type>(bytes), [&](arg_type b, arg_type e) {
+            std::memcpy(out + b, in + b, e - b);
+        }, COPY_GRAIN);
+    }
+
+    inline std::string segment_name(const std::string& name)
+    {
+        if (name.empty() || name.size() > 250 || name.find('/', 1) != std::string::npos) {
+            throw std::invalid_argument("Shared::Invalid segment name " + name);
+        }
+        return name[0] == '/' ? name : "/" + name;
+    }
+
+    // ----------------- SYSTEM CALLS -----------------
+    inline int open_named(const std::string& name, bool create, bool writable)
+    {
+#if defined(__linux__)
+        const int flags = (writable ? O_RDWR : O_RDONLY) | (create ? O_CREAT | O_EXCL : 0) | O_CLOEXEC;
+        const int fd = ::shm_open(segment_name(name).c_str(), flags, 0600);
+        if (fd < 0) {
+            throw std::runtime_error(create ? "Shared::Can't create segment " + name
+                                            : "Shared::Can't open segment " + name);
+        }
+        return fd;
+#else
+        throw std::runtime_error("Shared::Shared memory segments need Linux");
+#endif
+    }
+
+    inline int open_anonymous()
+    {
+#if defined(__linux__)
+        const int fd = ::memfd_create("numc", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd < 0) throw std::runtime_error("Shared::Can't create an anonymous segment");
+        return fd;
+#else
+        throw std::runtime_error("Shared::Shared memory segments need Linux");
+#endif
+    }
+
+    inline void unlink_named(const std::string& name)
+    {
+#if defined(__linux__)
+        if (::shm_unlink(segment_name(name).c_str()) != 0) {
+            throw std::runtime_error("Shared::Can't unlink segment " + name);
+        }
+#else
+        throw std::runtime_error("Shared::Shared memory segments need Linux");
+#endif
+    }
+
+    inline int duplicate(int fd)
+    {
+#if defined(__linux__)
+        const int copy = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (copy < 0) throw std::runtime_error("Shared::Invalid segment descriptor");
+        return copy;
+#else
+        throw std::runtime_error("Shared::Shared memory segments need Linux");
+#endif
+    }
+
+    inline void close_fd(int fd) noexcept
+    {
+#if defined(__linux__)
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    // Sizes a new segment; memfds are then sealed so no process can shrink them under
+    // another one's mapping
+    inline void resize(int fd, std::size_t bytes)
+    {
+#if defined(__linux__)
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            close_fd(fd);
+            throw std::runtime_error("Shared::Can't allocate " + std::to_string(bytes) + " bytes");
+        }
+        ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+#endif
+    }
+
+    inline std::size_t segment_bytes(int fd)
+    {
+#if defined(__linux__)
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            close_fd(fd);
+            throw std::runtime_error("Shared::Invalid segment descriptor");
+        }
+        return static_cast<std::size_t>(info.st_size);
+#else
+        return 0;
+#endif
+    }
+
+    // Sleeps while word still holds expected. The futex is shared rather than private,
+    // so it is keyed on the mapped object and wakes sleepers in every process.
+    inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected)
+    {
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+#else
+        (void)word;
+        (void)expected;
+        std::this_thread::yield();
+#endif
+    }
+
+    inline void futex_wake(std::atomic<std::uint32_t>& word)
+    {
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+
+    // Sleeps on signal unless ready() holds once registered as a waiter. Whoever makes
+    // ready() true calls notify afterwards, so the change either shows in ready() or
+    // moves signal past the value read here and the wait returns at once.
+    template <typename Ready>
+    void wait_signal(std::atomic<std::uint32_t>& signal, std::atomic<std::uint32_t>& waiters, Ready ready)
+    {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint32_t seen = signal.load(std::memory_order_seq_cst);
+        if (!ready()) futex_wait(signal, seen);
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // The system call is skipped while nobody sleeps on signal
+    inline void notify(std::atomic<std::uint32_t>& signal, std::atomic<std::uint32_t>& waiters)
+    {
+        signal.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_seq_cst) != 0) futex_wake(signal);
+    }
+
+    // ----------------- MAPPING -----------------
+    inline
+    Mapping::Mapping(int fd, std::size_t bytes, bool writable)
+        : m_bytes(bytes)
+        , m_fd(fd)
+        , m_writable(writable)
+    {
+#if defined(__linux__)
+        void* mapped = ::mmap(nullptr, bytes, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close_fd(fd);
+            throw std::runtime_error("Shared::Can't map " + std::to_string(bytes) + " bytes");
+        }
+        m_data = static_cast<char*>(mapped);
+#endif
+    }
+
+    inline
+    Mapping::Mapping(Mapping&& rhv) noexcept
+        : m_data(std::exchange(rhv.m_data, nullptr))
+        , m_bytes(std::exchange(rhv.m_bytes, 0))
+        , m_fd(std::exchange(rhv.m_fd, -1))
+        , m_writable(rhv.m_writable)
+    {}
+
+    inline Mapping&
+    Mapping::operator=(Mapping&& rhv) noexcept
+    {
+        if (this != &rhv) {
+            release();
+            m_data = std::exchange(rhv.m_data, nullptr);
+            m_bytes = std::exchange(rhv.m_bytes, 0);
+            m_fd = std::exchange(rhv.m_fd, -1);
+            m_writable = rhv.m_writable;
+        }
+        return *this;
+    }
+
+    inline
+    Mapping::~Mapping()
+    {
+        release();
+    }
+
+    inline void
+    Mapping::release() noexcept
+    {
+#if defined(__linux__)
+        if (m_data) ::munmap(m_data, m_bytes);
+#endif
+        close_fd(m_fd);
+        m_data = nullptr;
+        m_fd = -1;
+    }
+
+    template <typename T>
+    void write_header(SegmentHeader& header, const char (&magic)[8], const Shape& shape, std::size_t data_bytes)
+    {
+        if (static_cast<arg_type>(shape.size()) > MAX_DIMS) {
+            throw std::invalid_argument("Shared::At most " + std::to_string(MAX_DIMS) + " dimensions");
+        }
+        std::memcpy(header.magic, magic, sizeof(header.magic));
+        header.kind = NumC::detail::type_kind<T>();
+        header.width = static_cast<char>(sizeof(T));
+        header.ndim = static_cast<std::uint32_t>(shape.size());
+        header.data_offset = align_up(sizeof(SegmentHeader));
+        header.data_bytes = data_bytes;
+        for (std::size_t d = 0; d < shape.size(); ++d) header.dims[d] = shape[d];
+    }
+
+    // Shape of a segment made by another process, after checking it describes T values
+    template <typename T>
+    Shape read_header(const SegmentHeader& header, const char (&magic)[8], std::size_t bytes)
+    {
+        if (bytes < sizeof(SegmentHeader) || std::memcmp(header.magic, magic, sizeof(header.magic)) != 0
+            || header.ndim > static_cast<std::uint32_t>(MAX_DIMS)) {
+            throw std::runtime_error("Shared::Not a NumC segment");
+        }
+        if (header.kind != NumC::detail::type_kind<T>() || header.width != static_cast<char>(sizeof(T))) {
+            throw std::runtime_error("Shared::Element type doesn't match the segment");
+        }
+        if (header.data_offset < sizeof(SegmentHeader) || header.data_offset > bytes
+            || header.data_bytes > bytes - header.data_offset) {
+            throw std::runtime_error("Shared::Segment is truncated");
+        }
+        return Shape(header.dims, header.dims + header.ndim);
+    }
+}
+
+// ----------------- SHARED ARRAY -----------------
+template <typename T>
+SharedArray<T>
+SharedArray<T>::create(const std::string& name, const Shape& shape)
+{
+    const int fd = detail::open_named(name, true, true);
+    try {
+        return create_in(fd, shape);
+    } catch (...) {
+        detail::unlink_named(name);
+        throw;
+    }
+}
+
+template <typename T>
+SharedArray<T>
+SharedArray<T>::create(const std::string& name, const Array<T>& values)
+{
+    SharedArray<T> shared = create(name, values.shape());
+    detail::copy_bytes(shared.s_data, values.data(), values.size() * sizeof(T));
+    return shared;
+}
+
+template <typename T>
+SharedArray<T>
+SharedArray<T>::create_anonymous(const Shape& shape)
+{
+    return create_in(detail::open_anonymous(), shape);
+}
+
+template <typename T>
+SharedArray<T>
+SharedArray<T>::create_anonymous(const Array<T>& values)
+{
+    SharedArray<T> shared = create_anonymous(values.shape());
+    detail::copy_bytes(shared.s_data, values.data(), values.size() * sizeof(T));
+    return shared;
+}
+
+template <typename T>
+SharedArray<T>
+SharedArray<T>::create_in(int fd, const Shape& shape)
+{
+    if (static_cast<arg_type>(shape.size()) > MAX_DIMS) {
+        detail::close_fd(fd);
+        throw std::invalid_argument("Shared::At most " + std::to_string(MAX_DIMS) + " dimensions");
+    }
+    const std::size_t data_bytes = shape.total() * sizeof(T);
+    const std::size_t offset = detail::align_up(sizeof(detail::SegmentHeader));
+    detail::resize(fd, offset + data_bytes);
+
+    SharedArray<T> shared;
+    shared.s_mapping = detail::Mapping(fd, offset + data_bytes, true);
+    auto* header = reinterpret_cast<detail::SegmentHeader*>(shared.s_mapping.data());
+    detail::write_header<T>(*header, detail::ARRAY_MAGIC, shape, data_bytes);
+    shared.s_shape = shape;
+    shared.s_size = shape.total();
+    shared.s_data = reinterpret_cast<T*>(shared.s_mapping.data() + offset);
+    return shared;
+}
+
+template <typename T>
+SharedArray<T>
+SharedArray<T>::attach(const std::string& name)
+{
+    return attach_to(detail::open_named(name, false, false));
+}
+
+template <typename T>
+SharedArray<T>
+SharedArray<T>::attach(int fd)
+{
+    return attach_to(detail::duplicate(fd));
+}
+
+template <typename T>
+SharedArray<T>
+SharedArray<T>::attach_to(int fd)
+{
+    const std::size_t bytes = detail::segment_bytes(fd);
+    SharedArray<T> shared;
+    shared.s_mapping = detail::Mapping(fd, bytes, false);
+    const auto& header = *reinterpret_cast<const detail::SegmentHeader*>(shared.s_mapping.data());
+    shared.s_shape = detail::read_header<T>(header, detail::ARRAY_MAGIC, bytes);
+    shared.s_size = shared.s_shape.total();
+    if (static_cast<std::size_t>(shared.s_size) * sizeof(T) != header.data_bytes) {
+        throw std::runtime_error("Shared::Segment size doesn't match its shape");
+    }
+    shared.s_data = reinterpret_cast<T*>(shared.s_mapping.data() + header.data_offset);
+    return shared;
+}
+
+template <typename T>
+void
+SharedArray<T>::unlink(const std::string& name)
+{
+    detail::unlink_named(name);
+}
+
+template <typename T>
+arg_type
+SharedArray<T>::size() const
+{
+    return s_size;
+}
+
+template <typename T>
+const Shape&
+SharedArray<T>::shape() const
+{
+    return s_shape;
+}
+
+template <typename T>
+bool
+SharedArray<T>::writable() const
+{
+    return s_mapping.writable();
+}
+
+template <typename T>
+int
+SharedArray<T>::fd() const
+{
+    return s_mapping.fd();
+}
+
+template <typename T>
+const T*
+SharedArray<T>::data() const
+{
+    return s_data;
+}
+
+template <typename T>
+T*
+SharedArray<T>::mutable_data()
+{
+    if (!writable()) throw std::runtime_error("Shared::Segment is attached read-only");
+    return s_data;
+}
+
+template <typename T>
+Viewer<T>
+SharedArray<T>::view()
+{
+    T* values = mutable_data();
+    return Viewer<T>(values, values + s_size, s_shape);
+}
+
+template <typename T>
+Viewer<T>
+SharedArray<T>::view(const std::vector<Slice>& slices)
+{
+    T* values = mutable_data();
+    if (slices.size() > s_shape.size()) {
+        throw std::invalid_argument("Too many slices for the array's dimensions.");
+    }
+    std::vector<Slice> normalized(slices);
+    for (std::size_t d = 0; d < normalized.size(); ++d) normalized[d].normalize(s_shape[d]);
+    return Viewer<T>(values, values + s_size, s_shape, normalized);
+}
+
+template <typename T>
+ConstViewer<T>
+SharedArray<T>::const_view() const
+{
+    return ConstViewer<T>(s_data, s_data + s_size, s_shape);
+}
+
+template <typename T>
+ConstViewer<T>
+SharedArray<T>::const_view(const std::vector<Slice>& slices) const
+{
+    if (slices.size() > s_shape.size()) {
+        throw std::invalid_argument("Too many slices for the array's dimensions.");
+    }
+    std::vector<Slice> normalized(slices);
+    for (std::size_t d = 0; d < normalized.size(); ++d) normalized[d].normalize(s_shape[d]);
+    return ConstViewer<T>(s_data, s_data + s_size, s_shape, normalized);
+}
+
+template <typename T>
+Array<T>
+SharedArray<T>::copy() const
+{
+    Array<T> result = Array<T>::uninitialized(s_shape);
+    detail::copy_bytes(result.data(), s_data, s_size * sizeof(T));
+    return result;
+}
+
+// ----------------- SHARED RING -----------------
+// Slot i of the ring serves positions i, i + slots, ... Its sequence is `position`
+// while free for the producer, `position + 1` once published and `position + slots`
+// after the consumer releases it.
+template <typename T>
+struct SharedRing<T>::Header
+{
+    detail::SegmentHeader layout;               // slot shape
+    std::uint64_t slots;
+    std::uint64_t slot_stride;                  // bytes from one slot header to the next
+    alignas(STORAGE_ALIGNMENT) std::atomic<std::uint64_t> head;     // next position to publish
+    alignas(STORAGE_ALIGNMENT) std::atomic<std::uint64_t> tail;     // next position to pop
+    alignas(STORAGE_ALIGNMENT) std::atomic<std::uint32_t> closed;
+};
+
+template <typename T>
+struct SharedRing<T>::SlotHeader
+{
+    alignas(STORAGE_ALIGNMENT) std::atomic<std::uint64_t> sequence;
+    std::uint64_t rows;
+    // Bumped after every publish or release of the slot and on close; blocked pushes
+    // and pops sleep on it
+    std::atomic<std::uint32_t> signal;
+    std::atomic<std::uint32_t> waiters;
+};
+
+template <typename T>
+SharedRing<T>
+SharedRing<T>::create(const std::string& name, arg_type slots, const Shape& slot_shape)
+{
+    const int fd = detail::open_named(name, true, true);
+    try {
+        return create_in(fd, slots, slot_shape);
+    } catch (...) {
+        detail::unlink_named(name);
+        throw;
+    }
+}
+
+template <typename T>
+SharedRing<T>
+SharedRing<T>::create_anonymous(arg_type slots, const Shape& slot_shape)
+{
+    return create_in(detail::open_anonymous(), slots, slot_shape);
+}
+
+template <typename T>
+SharedRing<T>
+SharedRing<T>::create_in(int fd, arg_type slots, const Shape& slot_shape)
+{
+    if (slots < 1 || slot_shape.size() == 0 || static_cast<arg_type>(slot_shape.size()) > MAX_DIMS) {
+        detail::close_fd(fd);
+        throw std::invalid_argument("SharedRing::Needs at least one slot and 1 to "
+                                    + std::to_string(MAX_DIMS) + " slot dimensions");
+    }
+    const std::size_t slot_bytes = slot_shape.total() * sizeof(T);
+    const std::size_t stride = detail::align_up(sizeof(SlotHeader) + slot_bytes);
+    const std::size_t offset = detail::align_up(sizeof(Header));
+    detail::resize(fd, offset + slots * stride);
+
+    SharedRing<T> ring;
+    ring.r_mapping = detail::Mapping(fd, offset + slots * stride, true);
+    Header* header = new (ring.r_mapping.data()) Header;
+    detail::write_header<T>(header->layout, detail::RING_MAGIC, slot_shape, slots * stride);
+    header->layout.data_offset = offset;
+    header->slots = slots;
+    header->slot_stride = stride;
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    ring.r_header = header;
+    for (arg_type i = 0; i < slots; ++i) {
+        SlotHeader* entry = new (ring.r_mapping.data() + offset + i * stride) SlotHeader;
+        entry->rows = 0;
+        entry->signal.store(0, std::memory_order_relaxed);
+        entry->waiters.store(0, std::memory_order_relaxed);
+        entry->sequence.store(i, std::memory_order_release);
+    }
+    ring.r_slot_shape = slot_shape;
+    ring.r_row_size = slot_shape.total() / std::max<arg_type>(1, slot_shape[0]);
+    return ring;
+}
+
+template <typename T>
+SharedRing<T>
+SharedRing<T>::attach(const std::string& name)
+{
+    return attach_to(detail::open_named(name, false, true));
+}
+
+template <typename T>
+SharedRing<T>
+SharedRing<T>::attach(int fd)
+{
+    return attach_to(detail::duplicate(fd));
+}
+
+template <typename T>
+SharedRing<T>
+SharedRing<T>::attach_to(int fd)
+{
+    const std::size_t bytes = detail::segment_bytes(fd);
+    SharedRing<T> ring;
+    ring.r_mapping = detail::Mapping(fd, bytes, true);
+    if (bytes < sizeof(Header)) throw std::runtime_error("Shared::Not a NumC segment");
+    Header* header = reinterpret_cast<Header*>(ring.r_mapping.data());
+    ring.r_slot_shape = detail::read_header<T>(header->layout, detail::RING_MAGIC, bytes);
+    const std::size_t slot_bytes = ring.r_slot_shape.total() * sizeof(T);
+    if (ring.r_slot_shape.size() == 0 || header->slots < 1 || header->slot_stride < sizeof(SlotHeader) + slot_bytes
+        || header->layout.data_offset + header->slots * header->slot_stride > bytes) {
+        throw std::runtime_error("Shared::Segment is truncated");
+    }
+    ring.r_header = header;
+    ring.r_row_size = ring.r_slot_shape.total() / std::max<arg_type>(1, ring.r_slot_shape[0]);
+    return ring;
+}
+
+template <typename T>
+void
+SharedRing<T>::unlink(const std::string& name)
+{
+    detail::unlink_named(name);
+}
+
+template <typename T>
+arg_type
+SharedRing<T>::slots() const
+{
+    return r_header ? static_cast<arg_type>(r_header->slots) : 0;
+}
+
+template <typename T>
+const Shape&
+SharedRing<T>::slot_shape() const
+{
+    return r_slot_shape;
+}
+
+template <typename T>
+int
+SharedRing<T>::fd() const
+{
+    return r_mapping.fd();
+}
+
+template <typename T>
+typename SharedRing<T>::SlotHeader*
+SharedRing<T>::slot(std::uint64_t position) const
+{
+    return reinterpret_cast<SlotHeader*>(r_mapping.data() + r_header->layout.data_offset
+                                         + (position % r_header->slots) * r_header->slot_stride);
+}
+
+template <typename T>
+T*
+SharedRing<T>::slot_data(SlotHeader* header) const
+{
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(header) + sizeof(SlotHeader));
+}
+
+template <typename T>
+T*
+SharedRing<T>::try_reserve()
+{
+    if (!r_header) throw std::runtime_error("SharedRing::Ring is not open");
+    const std::uint64_t position = r_header->head.load(std::memory_order_relaxed);
+    SlotHeader* entry = slot(position);
+    if (entry->sequence.load(std::memory_order_acquire) != position) return nullptr;
+    r_reserved = true;
+    return slot_data(entry);
+}
+
+template <typename T>
+void
+SharedRing<T>::publish(arg_type rows)
+{
+    if (!r_reserved) throw std::runtime_error("SharedRing::publish without a reserved slot");
+    if (rows < 0 || rows > r_slot_shape[0]) {
+        throw std::invalid_argument("SharedRing::" + std::to_string(rows) + " rows don't fit the slot");
+    }
+    const std::uint64_t position = r_header->head.load(std::memory_order_relaxed);
+    SlotHeader* entry = slot(position);
+    entry->rows = rows;
+    entry->sequence.store(position + 1, std::memory_order_release);
+    r_header->head.store(position + 1, std::memory_order_release);
+    r_reserved = false;
+    detail::notify(entry->signal, entry->waiters);
+}
+
+template <typename T>
+bool
+SharedRing<T>::try_push(const Array<T>& batch)
+{
+    const Shape& shape = batch.shape();
+    if (shape.size() != r_slot_shape.size() || shape[0] > r_slot_shape[0]
+        || !std::equal(shape.begin() + 1, shape.end(), r_slot_shape.begin() + 1)) {
+        throw std::invalid_argument("SharedRing::Batch doesn't fit the slot shape");
+    }
+    T* out = try_reserve();
+    if (!out) return false;
+    detail::copy_bytes(out, batch.data(), batch.size() * sizeof(T));
+    publish(shape[0]);
+    return true;
+}
+
+template <typename T>
+bool
+SharedRing<T>::push(const Array<T>& batch)
+{
+    for (int attempt = 0; !closed(); ++attempt) {
+        if (try_push(batch)) return true;
+        if (attempt < detail::SPIN_LIMIT) continue;
+
+        // Full: the next slot frees up when its consumer releases it
+        const std::uint64_t position = r_header->head.load(std::memory_order_relaxed);
+        SlotHeader* entry = slot(position);
+        detail::wait_signal(entry->signal, entry->waiters, [&]() {
+            return r_header->closed.load(std::memory_order_seq_cst) != 0
+                || entry->sequence.load(std::memory_order_seq_cst) == position;
+        });
+    }
+    return false;
+}
+
+template <typename T>
+void
+SharedRing<T>::close()
+{
+    if (!r_header) return;
+    r_header->closed.store(1, std::memory_order_seq_cst);
+    for (std::uint64_t i = 0; i < r_header->slots; ++i) {
+        SlotHeader* entry = slot(i);
+        detail::notify(entry->signal, entry->waiters);
+    }
+}
+
+template <typename T>
+bool
+SharedRing<T>::closed() const
+{
+    return !r_header || r_header->closed.load(std::memory_order_acquire) != 0;
+}
+
+template <typename T>
+typename SharedRing<T>::Batch
+SharedRing<T>::try_pop()
+{
+    if (!r_header) return Batch();
+    std::uint64_t position = r_header->tail.load(std::memory_order_relaxed);
+    for (;;) {
+        SlotHeader* entry = slot(position);
+        const std::uint64_t sequence = entry->sequence.load(std::memory_order_acquire);
+        const std::int64_t ahead = static_cast<std::int64_t>(sequence - (position + 1));
+        if (ahead < 0) return Batch();          // not published yet
+        if (ahead > 0) {                        // another consumer took it
+            position = r_header->tail.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (r_header->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+            Shape shape(r_slot_shape);
+            shape[0] = static_cast<arg_type>(entry->rows);
+            return Batch(entry, position + r_header->slots, slot_data(entry), shape);
+        }
+    }
+}
+
+template <typename T>
+typename SharedRing<T>::Batch
+SharedRing<T>::pop()
+{
+    for (int attempt = 0;; ++attempt) {
+        // Read before trying, so a close seen here covers every batch published before it
+        const bool done = closed();
+        Batch batch = try_pop();
+        if (batch || done) return batch;
+        if (attempt < detail::SPIN_LIMIT) continue;
+
+        // Empty: sleep on the slot the next batch will be published to. Positions are
+        // published in order, so while that one isn't nothing else is either.
+        const std::uint64_t position = r_header->tail.load(std::memory_order_seq_cst);
+        SlotHeader* entry = slot(position);
+        detail::wait_signal(entry->signal, entry->waiters, [&]() {
+            const std::uint64_t sequence = entry->sequence.load(std::memory_order_seq_cst);
+            return r_header->closed.load(std::memory_order_seq_cst) != 0
+                || r_header->tail.load(std::memory_order_seq_cst) != position
+                || static_cast<std::int64_t>(sequence - (position + 1)) >= 0;
+        });
+    }
+}
+
+// ----------------- BATCH -----------------
+template <typename T>
+SharedRing<T>::Batch::Batch(SlotHeader* slot, std::uint64_t next, const T* data, Shape shape)
+    : b_slot(slot)
+    , b_next(next)
+    , b_data(data)
+    , b_shape(shape)
+{}
+
+template <typename T>
+SharedRing<T>::Batch::Batch(Batch&& rhv) noexcept
+    : b_slot(std::exchange(rhv.b_slot, nullptr))
+    , b_next(rhv.b_next)
+    , b_data(std::exchange(rhv.b_data, nullptr))
+    , b_shape(rhv.b_shape)
+{}
+
+template <typename T>
+typename SharedRing<T>::Batch&
+SharedRing<T>::Batch::operator=(Batch&& rhv) noexcept
+{
+    if (this != &rhv) {
+        release();
+        b_slot = std::exchange(rhv.b_slot, nullptr);
+        b_next = rhv.b_next;
+        b_data = std::exchange(rhv.b_data, nullptr);
+        b_shape = rhv.b_shape;
+    }
+    return *this;
+}
+
+template <typename T>
+SharedRing<T>::Batch::~Batch()
+{
+    release();
+}
+
+template <typename T>
+void
+SharedRing<T>::Batch::release()
+{
+    if (b_slot) {
+        b_slot->sequence.store(b_next, std::memory_order_release);
+        detail::notify(b_slot->signal, b_slot->waiters);
+    }
+    b_slot = nullptr;
+    b_data = nullptr;
+}
+
+template <typename T>
+arg_type
+SharedRing<T>::Batch::size() const
+{
+    return b_data ? b_shape.total() : 0;
+}
+
+template <typename T>
+Array<T>
+SharedRing<T>::Batch::copy() const
+{
+    Array<T> result = Array<T>::uninitialized(b_shape);
+    detail::copy_bytes(result.data(), b_data, size() * sizeof(T));
+    return result;
+}
+
+}
@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+namespace SamH::NumC::Global
+{
+
+namespace detail
+{
+    // Adds weight_of(i) to out[bin_of(i)] for i in [0, n); a negative bin skips the element.
+    // Every thread fills its own private bins, which are summed at the end.
+    template <typename W, typename BinOf, typename WeightOf>
+    void accumulate_bins(arg_type n, arg_type length, BinOf bin_of, WeightOf weight_of, W* out)
+    {
+        arg_type chunks = Parallel::chunk_count(n);
+        // Private copies only pay off while they are small compared to the input
+        if (chunks > 1 && length * chunks > 2 * n + (1 << 16)) chunks = 1;
+
+        if (chunks <= 1) {
+            for (arg_type i = 0; i < n; ++i) {
+                const arg_type b = bin_of(i);
+                if (b >= 0) out[b] += weight_of(i);
+            }
+            return;
+        }
+
+        std::vector<std::vector<W>> local(chunks);
+        Parallel::parallel_chunks(0, n, chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+            std::vector<W>& bins = local[chunk];
+            bins.assign(length, W(0));
+            for (arg_type i = b; i < e; ++i) {
+                const arg_type bin = bin_of(i);
+                if (bin >= 0) bins[bin] += weight_of(i);
+            }
+        });
+        Parallel::parallel_for(0, length, [&](arg_type b, arg_type e) {
+            for (const auto& bins : local) {
+                if (bins.empty()) continue;
+                for (arg_type i = b; i < e; ++i) out[i] += bins[i];
+            }
+        });
+    }
+
+    // Largest value of a non-negative integer array, -1 when empty
+    template <typename T>
+    arg_type max_bin_value(const Array<T>& arr)
+    {
+        static_assert(std::is_integral_v<T>, "bincount requires an integer array");
+        const T* src = arr.data();
+        const arg_type chunks = Parallel::chunk_count(arr.size());
+        std::vector<arg_type> partial(std::max<arg_type>(1, chunks), -1);
+        Parallel::parallel_chunks(0, arr.size(), chunks, [&](arg_type chunk, arg_type b, arg_type e) {
+            arg_type best = -1;
+            for (arg_type i = b; i < e; ++i) {
+                if (src[i] < 0) throw std::invalid_argument("bincount::Values must be non-negative");
+                best = std::max<arg_type>(best, src[i]);
+            }
+            partial[chunk] = best;
+        });
+        return *std::max_element(partial.begin(), partial.end());
+    }
+}
+
+// ----------------- BINCOUNT -----------------
+
+template <typename T>
+Array<arg_type>
+bincount(const Array<T>& arr, arg_type minlength)
+{
+    const arg_type length = std::max(detail::max_bin_value(arr) + 1, minlength);
+    Array<arg_type> res(Shape{length}, 0);
+    const T* src = arr.data();
+    detail::accumulate_bins<arg_type>(arr.size(), length,
+        [&](arg_type i) { return static_cast<arg_type>(src[i]); },
+        [](arg_type) { return arg_type(1); },
+        res.data());
+    return res;
+}
+
+template <typename T, typename W>
+Array<W>
+bincount(const Array<T>& arr, const Array<W>& weights, arg_type minlength)
+{
+    if (arr.size() != weights.size()) {
+        throw std::invalid_argument("bincount::Weights must have the same size as the input");
+    }
+    const arg_type length = std::max(detail::max_bin_value(arr) + 1, minlength);
+    Array<W> res(Shape{length}, W(0));
+    const T* src = arr.data();
+    const W* w = weights.data();
+    detail::accumulate_bins<W>(arr.size(), length,
+        [&](arg_type i) { return static_cast<arg_type>(src[i]); },
+        [&](arg_type i) { return w[i]; },
+        res.data());
+    return res;
+}
+
+// ----------------- HISTOGRAM -----------------
+
+template <typename T>
+Histogram
+histogram(const Array<T>& arr, arg_type bins)
+{
+    if (arr.size() == 0) return histogram(arr, bins, 0.0, 1.0);
+    return histogram(arr, bins, static_cast<double>(arr.min()), static_cast<double>(arr.max()));
+}
+
+template <typename T>
+Histogram
+histogram(const Array<T>& arr, arg_type bins, double low, double high)
+{
+    if (bins <= 0) throw std::invalid_argument("histogram::Number of bins must be positive");
+    if (!(low <= high)) throw std::invalid_argument("histogram::Invalid range");
+    if (low == high) { low -= 0.5; high += 0.5; }
+
+    Histogram res{ Array<arg_type>(Shape{bins}, 0), Array<double>(Shape{bins + 1}, 0.0) };
+    double* edges = res.edges.data();
+    for (arg_type i = 0; i <= bins; ++i) edges[i] = low + (high - low) * i / bins;
+
+    // Uniform bins: the index is a multiply, corrected by one step against the
+    // exact edges where rounding lands a value on the wrong side of a boundary
+    const double scale = bins / (high - low);
+    const T* src = arr.data();
+    detail::accumulate_bins<arg_type>(arr.size(), bins,
+        [&](arg_type i) -> arg_type {
+            const double x = static_cast<double>(src[i]);
+            if (!(x >= low && x <= high)) return -1;
+            arg_type b = std::min(static_cast<arg_type>((x - low) * scale), bins - 1);
+            if (x < edges[b]) --b;
+            else if (b + 1 < bins && x >= edges[b + 1]) ++b;
+            return b;
+        },
+        [](arg_type) { return arg_type(1); },
+        res.counts.data());
+    return res;
+}
+
+template <typename T>
+Histogram
+histogram(const Array<T>& arr, const Array<double>& edges)
+{
+    const arg_type bins = edges.size() - 1;
+    if (bins <= 0) throw std::invalid_argument("histogram::At least two bin edges are required");
+    const double* e = edges.data();
+    if (!std::is_sorted(e, e + edges.size())) {
+        throw std::invalid_argument("histogram::Bin edges must be increasing");
+    }
+
+    Histogram res{ Array<arg_type>(Shape{bins}, 0), edges };
+    const T* src = arr.data();
+    detail::accumulate_bins<arg_type>(arr.size(), bins,
+        [&](arg_type i) -> arg_type {
+            const double x = static_cast<double>(src[i]);
+            if (!(x >= e[0] && x <= e[bins])) return -1;
+            const arg_type b = std::upper_bound(e, e + bins + 1, x) - e - 1;
+            return std::min(b, bins - 1);   // the last bin is closed on the right
+        },
+        [](arg_type) { return arg_type(1); },
+        res.counts.data());
+    return res;
+}
+
+// ----------------- DIGITIZE -----------------
+
+template <typename T>
+Array<arg_type>
+digitize(const Array<T>& arr, const Array<T>& bins, bool right)
+{
+    const T* b = bins.data();
+    const T* b_end = b + bins.size();
+    if (!std::is_sorted(b, b_end)) throw std::invalid_argument("digitize::Bins must be increasing");
+
+    Array<arg_type> res(Shape{arr.size()}, 0);
+    arg_type* out = res.data();
+    const T* src = arr.data();
+    Parallel::parallel_for(0, arr.size(), [&](arg_type first, arg_type last) {
+        for (arg_type i = first; i < last; ++i) {
+            out[i] = right ? std::lower_bound(b, b_end, src[i]) - b
+                           : std::upper_bound(b, b_end, src[i]) - b;
+        }
+    });
+    return res;
+}
+
+// ----------------- QUANTILE -----------------
+
+template <typename T>
+Array<double>
+quantile(const Array<T>& arr, const Array<double>& q)
+{
+    const arg_type n = arr.size();
+    if (n == 0) throw std::invalid_argument("quantile::Array is empty");
+    for (arg_type i = 0; i < q.size(); ++i) {
+        if (!(q[i] >= 0.0 && q[i] <= 1.0)) throw std::invalid_argument("quantile::q must be in [0, 1]");
+    }
+
+    // Answer the requested quantiles in increasing order; each selection only
+    // partitions the part of the buffer that is still unordered
+    std::vector<arg_type> order(q.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](arg_type a, arg_type b) { return q[a] < q[b]; });
+
+    std::vector<T> tmp(arr.begin(), arr.end());
+    arg_type start = 0;
+    auto select = [&](arg_type pos) -> double {
+        if (pos >= start) {
+            std::nth_element(tmp.begin() + start, tmp.begin() + pos, tmp.end());
+            start = pos + 1;
+        }
+        return static_cast<double>(tmp[pos]);
+    };
+
+    Array<double> res(Shape{q.size()}, 0.0);
+    for (arg_type idx : order) {
+        const double pos = q[idx] * (n - 1);
+        const arg_type lo = static_cast<arg_type>(std::floor(pos));
+        const double frac = pos - lo;
+        const double lower = select(lo);
+        res[idx] = (frac > 0.0 && lo + 1 < n) ? lower + frac * (select(lo + 1) - lower) : lower;
+    }
+    return res;
+}
+
+template <typename T>
+double
+quantile(const Array<T>& arr, double q)
+{
+    return quantile(arr, Array<double>({q}))[0];
+}
+
+template <typename T>
+double
+percentile(const Array<T>& arr, double p)
+{
+    return quantile(arr, p / 100.0);
+}
+
+template <typename T>
+Array<double>
+percentile(const Array<T>& arr, const Array<double>& p)
+{
+    Array<double> q(p);
+    for (arg_type i = 0; i < q.size(); ++i) q[i] /= 100.0;
+    return quantile(arr, q);
+}
+
+// ----------------- QUANTILE SKETCH -----------------
+
+template <typename T>
+QuantileSketch<T>::QuantileSketch(arg_type k)
+    : q_k(std::max<arg_type>(8, k))
+    , q_count(0)
+    , q_retained(0)
+    , q_state(0x9E3779B97F4A7C15ULL)
+    , q_levels(1)
+{}
+
+template <typename T>
+arg_type
+QuantileSketch<T>::capacity(std::size_t level) const
+{
+    // Lower levels get geometrically smaller buffers (factor 2/3 per level)
+    const std::size_t depth = q_levels.size() - 1 - level;
+    const double cap = std::ceil(q_k * std::pow(2.0 / 3.0, static_cast<double>(depth)));
+    return std::max<arg_type>(2, static_cast<arg_type>(cap));
+}
+
+template <typename T>
+bool
+QuantileSketch<T>::coin()
+{
+    q_state ^= q_state << 13;
+    q_state ^= q_state >> 7;
+    q_state ^= q_state << 17;
+    return q_state & 1;
+}
+
+template <typename T>
+void
+QuantileSketch<T>::compress()
+{
+    auto total_capacity = [&] {
+        arg_type total = 0;
+        for (std::size_t h = 0; h < q_levels.size(); ++h) total += capacity(h);
+        return total;
+    };
+
+    while (q_retained > total_capacity()) {
+        for (std::size_t h = 0; h < q_levels.size(); ++h) {
+            if (static_cast<arg_type>(q_levels[h].size()) < capacity(h)) continue;
+            if (h + 1 == q_levels.size()) q_levels.emplace_back();
+
+            // Sort the level and promote every other item, each now standing for twice the weight
+            std::vector<T>& level = q_levels[h];
+            std::sort(level.begin(), level.end());
+            T leftover = T();
+            const bool odd = level.size() % 2 == 1;
+            if (odd) { leftover = level.back(); level.pop_back(); }
+
+            std::vector<T>& next = q_levels[h + 1];
+            for (std::size_t i = coin() ? 1 : 0; i < level.size(); i += 2) next.push_back(level[i]);
+
+            q_retained -= level.size() / 2;
+            level.clear();
+            if (odd) level.push_back(leftover);
+            break;
+        }
+    }
+}
+
+template <typename T>
+void
+QuantileSketch<T>::update(const T& value)
+{
+    q_levels[0].push_back(value);
+    ++q_count;
+    ++q_retained;
+    if (static_cast<arg_type>(q_levels[0].size()) >= capacity(0)) compress();
+}
+
+template <typename T>
+void
+QuantileSketch<T>::update(const Array<T>& values)
+{
+    for (const auto& v : values) update(v);
+}
+
+template <typename T>
+void
+QuantileSketch<T>::merge(const QuantileSketch& other)
+{
+    if (q_levels.size() < other.q_levels.size()) q_levels.resize(other.q_levels.size());
+    for (std::size_t h = 0; h < other.q_levels.size(); ++h) {
+        q_levels[h].insert(q_levels[h].end(), other.q_levels[h].begin(), other.q_levels[h].end());
+    }
+    q_count += other.q_count;
+    q_retained += other.q_retained;
+    compress();
+}
+
+template <typename T>
+Array<T>
+QuantileSketch<T>::quantile(const Array<double>& q) const
+{
+    if (q_count == 0) throw std::invalid_argument("QuantileSketch::No values were added");
+
+    // Weighted items sorted by value; an item on level h stands for 2^h inputs
+    std::vector<std::pair<T, arg_type>> items;
+    items.reserve(q_retained);
+    for (std::size_t h = 0; h < q_levels.size(); ++h) {
+        for (const auto& v : q_levels[h]) items.emplace_back(v, arg_type(1) << h);
+    }
+    std::sort(items.begin(), items.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<arg_type> cumulative(items.size());
+    arg_type running = 0;
+    for (std::size_t i = 0; i < items.size(); ++i) cumulative[i] = (running += items[i].second);
+
+    Array<T> res(Shape{q.size()}, T());
+    for (arg_type i = 0; i < q.size(); ++i) {
+        if (!(q[i] >= 0.0 && q[i] <= 1.0)) throw std::invalid_argument("quantile::q must be in [0, 1]");
+        const double target = q[i] * running;
+        const auto it = std::lower_bound(cumulative.begin(), cumulative.end(), target,
+                                         [](arg_type c, double t) { return c < t; });
+        res[i] = items[std::min<std::size_t>(it - cumulative.begin(), items.size() - 1)].first;
+    }
+    return res;
+}
+
+template <typename T>
+T
+QuantileSketch<T>::quantile(double q) const
+{
+    return quantile(Array<double>({q}))[0];
+}
+
+template <typename T>
+arg_type
+QuantileSketch<T>::count() const
+{
+    return q_count;
+}
+
+template <typename T>
+arg_type
+QuantileSketch<T>::retained() const
+{
+    return q_retained;
+}
+
+}
@@ -0,0 +1,166 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace SamH::NumC
+{
+
+namespace Storage
+{
+    namespace detail
+    {
+        struct Settings
+        {
+            std::atomic<int> policy;
+            std::atomic<std::size_t> threshold;
+
+            Settings()
+                : policy(TRANSPARENT)
+                , threshold(HUGE_PAGE_SIZE * 2)
+            {
+                if (const char* env = std::getenv("NUMC_HUGE_PAGES")) {
+                    if      (std::strcmp(env, "none") == 0)        policy = NONE;
+                    else if (std::strcmp(env, "transparent") == 0) policy = TRANSPARENT;
+                    else if (std::strcmp(env, "explicit") == 0)    policy = EXPLICIT;
+                }
+            }
+        };
+
+        inline Settings& settings()
+        {
+            static Settings instance;
+            return instance;
+        }
+
+        // Stored in the cache line in front of every buffer so deallocate knows how it was obtained
+        struct BlockHeader
+        {
+            void* base;
+            std::size_t mapped;     // length of a MAP_HUGETLB mapping, 0 for heap blocks
+        };
+        static_assert(sizeof(BlockHeader) <= STORAGE_ALIGNMENT);
+
+        inline std::size_t round_up(std::size_t bytes, std::size_t to)
+        {
+            return (bytes + to - 1) / to * to;
+        }
+
+        inline void* place(void* base, std::size_t mapped)
+        {
+            char* data = static_cast<char*>(base) + STORAGE_ALIGNMENT;
+            BlockHeader* header = reinterpret_cast<BlockHeader*>(data) - 1;
+            header->base = base;
+            header->mapped = mapped;
+            return data;
+        }
+
+        inline void* aligned_block(std::size_t alignment, std::size_t bytes)
+        {
+            void* base = std::aligned_alloc(alignment, round_up(bytes, alignment));
+            if (!base) throw std::bad_alloc();
+            return base;
+        }
+    }
+
+    inline HugePages
+    huge_pages()
+    {
+        return static_cast<HugePages>(detail::settings().policy.load(std::memory_order_relaxed));
+    }
+
+    inline void
+    set_huge_pages(HugePages policy)
+    {
+        detail::settings().policy.store(policy, std::memory_order_relaxed);
+    }
+
+    inline std::size_t
+    huge_page_threshold()
+    {
+        return detail::settings().threshold.load(std::memory_order_relaxed);
+    }
+
+    inline void
+    set_huge_page_threshold(std::size_t bytes)
+    {
+        detail::settings().threshold.store(bytes, std::memory_order_relaxed);
+    }
+
+    inline void*
+    allocate(std::size_t bytes)
+    {
+        const std::size_t total = bytes + STORAGE_ALIGNMENT;
+        const HugePages policy = huge_pages();
+
+#if defined(__linux__)
+        if (policy != NONE && total >= huge_page_threshold()) {
+            const std::size_t length = detail::round_up(total, HUGE_PAGE_SIZE);
+            if (policy == EXPLICIT) {
+                void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (base != MAP_FAILED) return detail::place(base, length);
+            }
+            void* base = detail::aligned_block(HUGE_PAGE_SIZE, length);
+            madvise(base, length, MADV_HUGEPAGE);
+            return detail::place(base, 0);
+        }
+#else
+        (void)policy;
+#endif
+        return detail::place(detail::aligned_block(STORAGE_ALIGNMENT, total), 0);
+    }
+
+    inline void
+    deallocate(void* ptr) noexcept
+    {
+        if (!ptr) return;
+        const detail::BlockHeader* header = static_cast<const detail::BlockHeader*>(ptr) - 1;
+#if defined(__linux__)
+        if (header->mapped) {
+            munmap(header->base, header->mapped);
+            return;
+        }
+#endif
+        std::free(header->base);
+    }
+}
+
+// ----------------- ALIGNED ALLOCATOR -----------------
+
+template <typename T>
+T*
+AlignedAllocator<T>::allocate(std::size_t n)
+{
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc();
+    return static_cast<T*>(Storage::allocate(n * sizeof(T)));
+}
+
+template <typename T>
+void
+AlignedAllocator<T>::deallocate(T* ptr, std::size_t) noexcept
+{
+    Storage::deallocate(ptr);
+}
+
+template <typename T>
+template <typename U>
+void
+AlignedAllocator<T>::construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+{
+    ::new (static_cast<void*>(ptr)) U;
+}
+
+template <typename T>
+template <typename U, typename... Args>
+void
+AlignedAllocator<T>::construct(U* ptr, Args&&... args)
+{
+    ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+}
+
+}
@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SamH::NumC::Global
+{
+
+namespace detail
+{
+    // Bytes handed to the stream per write
+    constexpr std::size_t TEXT_FLUSH = std::size_t(1) << 16;
+    // Input bytes per parse segment
+    constexpr arg_type TEXT_SEGMENT = arg_type(1) << 20;
+
+    inline PrintOptions& print_settings()
+    {
+        static PrintOptions options;
+        return options;
+    }
+
+    // Types std::to_chars / std::from_chars handle; characters keep their stream formatting
+    template <typename T>
+    constexpr bool is_text_number = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>
+                                    && !std::is_same_v<T, char> && !std::is_same_v<T, signed char>
+                                    && !std::is_same_v<T, unsigned char>;
+
+    template <typename T>
+    void append_value(std::string& out, const T& value, int precision)
+    {
+        if constexpr (is_text_number<T>) {
+            char buffer[64];
+            std::to_chars_result res;
+            if constexpr (std::is_floating_point_v<T>) {
+                res = precision < 0 ? std::to_chars(buffer, buffer + sizeof(buffer), value)
+                                    : std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                                    std::chars_format::general, precision);
+            } else {
+                res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            }
+            out.append(buffer, res.ptr);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            out += value ? '1' : '0';
+        } else {
+            std::ostringstream stream;
+            if (precision >= 0) stream.precision(precision);
+            stream << value;
+            out += stream.str();
+        }
+    }
+
+    inline void flush_text(std::string& buffer, std::ostream& out, bool force = false)
+    {
+        if (!force && buffer.size() < TEXT_FLUSH) return;
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    // Read-only view of a whole file, mapped where possible
+    class TextFile
+    {
+    public:
+        explicit TextFile(const std::string& path)
+        {
+#if defined(__linux__)
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("loadtxt::Can't open " + path);
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+                void* mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    ::madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+                    t_mapped = static_cast<const char*>(mapped);
+                    t_size = info.st_size;
+                }
+            }
+            ::close(fd);
+            if (t_mapped) return;
+#endif
+            std::ifstream file(path, std::ios::binary);
+            if (!file) throw std::runtime_error("loadtxt::Can't open " + path);
+            t_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            t_size = t_buffer.size();
+        }
+
+        ~TextFile()
+        {
+#if defined(__linux__)
+            if (t_mapped) ::munmap(const_cast<char*>(t_mapped), t_size);
+#endif
+        }
+
+        TextFile(const TextFile&) = delete;
+        TextFile& operator=(const TextFile&) = delete;
+
+        const char* begin() const { return t_mapped ? t_mapped : t_buffer.data(); }
+        const char* end() const { return begin() + t_size; }
+
+    private:
+        const char* t_mapped = nullptr;
+        std::size_t t_size = 0;
+        std::vector<char> t_buffer;
+    };
+
+    inline bool is_blank(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    // Start of the line after p
+    inline const char* next_line(const char* p, const char* end)
+    {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        return newline ? newline + 1 : end;
+    }
+
+    // End of the line's content, before "\n" or "\r\n"
+    inline const char* content_end(const char* line, const char* next)
+    {
+        const char* e = next;
+        if (e > line && e[-1] == '\n') --e;
+        if (e > line && e[-1] == '\r') --e;
+        return e;
+    }
+
+    inline bool is_data_line(const char* b, const char* e, char comments)
+    {
+        while (b < e && is_blank(*b)) ++b;
+        return b < e && *b != comments;
+    }
+
+    // Parses the values of one line into out, returns how many there were (at most limit)
+    template <typename T>
+    arg_type parse_line(const char* p, const char* e, char delimiter, T* out, arg_type limit, arg_type row)
+    {
+        const bool blank_delimiter = is_blank(delimiter);
+        arg_type count = 0;
+        while (true) {
+            while (p < e && is_blank(*p)) ++p;
+            if (p < e && *p == '+') ++p;
+            T value;
+            const auto res = std::from_chars(p, e, value);
+            if (res.ec != std::errc()) {
+                const char* stop = p;
+                while (stop < e && *stop != delimiter && !is_blank(*stop)) ++stop;
+                throw std::invalid_argument("loadtxt::Can't parse '" + std::string(p, stop)
+                                            + "' in row " + std::to_string(row));
+            }
+            if (count < limit) out[count] = value;
+            ++count;
+
+            p = res.ptr;
+            while (p < e && is_blank(*p)) ++p;
+            if (p == e) return count;
+            if (!blank_delimiter) {
+                if (*p != delimiter) {
+                    throw std::invalid_argument("loadtxt::Unexpected '" + std::string(1, *p)
+                                                + "' in row " + std::to_string(row));
+                }
+                ++p;
+            }
+        }
+    }
+}
+
+// ----------------- OPTIONS -----------------
+
+inline PrintOptions
+print_options()
+{
+    return detail::print_settings();
+}
+
+inline void
+set_print_options(const PrintOptions& options)
+{
+    if (options.threshold < 0 || options.edge_items < 1) {
+        throw std::invalid_argument("set_print_options::Threshold and edge items must be positive");
+    }
+    detail::print_settings() = options;
+}
+
+// ----------------- LOADING -----------------
+
+template <typename T>
+Array<T>
+loadtxt(const std::string& path, char delimiter, arg_type skip_rows, char comments)
+{
+    static_assert(detail::is_text_number<T>, "loadtxt requires a numeric element type");
+    const detail::TextFile file(path);
+    const char* start = file.begin();
+    const char* const end = file.end();
+    for (arg_type r = 0; r < skip_rows && start < end; ++r) start = detail::next_line(start, end);
+
+    // The first data line fixes the column count
+    arg_type cols = 0;
+    for (const char* line = start; line < end && cols == 0;) {
+        const char* next = detail::next_line(line, end);
+        const char* e = detail::content_end(line, next);
+        if (detail::is_data_line(line, e, comments)) cols = detail::parse_line<T>(line, e, delimiter, nullptr, 0, 0);
+        line = next;
+    }
+    if (cols == 0) return Array<T>();
+
+    // Segment boundaries moved forward to line starts, so every line belongs to exactly one
+    const arg_type length = end - start;
+    const arg_type segments = Parallel::chunk_count(length, detail::TEXT_SEGMENT) * 4;
+    std::vector<const char*> bounds(segments + 1, end);
+    bounds[0] = start;
+    for (arg_type s = 1; s < segments; ++s) {
+        const char* raw = start + std::max<arg_type>(0, length * s / segments - 1);
+        bounds[s] = std::max(bounds[s - 1], detail::next_line(raw, end));
+    }
+
+    std::vector<arg_type> rows(segments + 1, 0);
+    Parallel::parallel_for(0, segments, [&](arg_type b, arg_type e) {
+        for (arg_type s = b; s < e; ++s) {
+            arg_type count = 0;
+            for (const char* line = bounds[s]; line < bounds[s + 1];) {
+                const char* next = detail::next_line(line, bounds[s + 1]);
+                count += detail::is_data_line(line, detail::content_end(line, next), comments);
+                line = next;
+            }
+            rows[s + 1] = count;
+        }
+    }, 1);
+    for (arg_type s = 0; s < segments; ++s) rows[s + 1] += rows[s];
+
+    const arg_type total_rows = rows[segments];
+    Shape shape{total_rows, cols};
+    if (cols == 1) shape = Shape{total_rows};
+    else if (total_rows == 1) shape = Shape{cols};
+    Array<T> res = Array<T>::uninitialized(shape);
+
+    Parallel::parallel_for(0, segments, [&](arg_type b, arg_type e) {
+        for (arg_type s = b; s < e; ++s) {
+            arg_type row = rows[s];
+            for (const char* line = bounds[s]; line < bounds[s + 1];) {
+                const char* next = detail::next_line(line, bounds[s + 1]);
+                const char* content = detail::content_end(line, next);
+                if (detail::is_data_line(line, content, comments)) {
+                    T* out = res.data() + row * cols;
+                    if (detail::parse_line(line, content, delimiter, out, cols, row) != cols) {
+                        throw std::invalid_argument("loadtxt::Row " + std::to_string(row)
+                                                    + " doesn't have " + std::to_string(cols) + " columns");
+                    }
+                    ++row;
+                }
+                line = next;
+            }
+        }
+    }, 1);
+    return res;
+}
+
+// ----------------- SAVING -----------------
+
+template <typename T>
+void
+savetxt(const std::string& path, const Array<T>& arr, char delimiter, int precision)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("savetxt::Can't open " + path + " for writing");
+
+    const Shape& dims = arr.shape();
+    const arg_type total = arr.size();
+    const arg_type cols = dims.size() > 1 ? dims[dims.size() - 1] : 1;
+    if (total == 0 || cols == 0) return;
+    const arg_type rows = total / cols;
+
+    // Rows are formatted in blocks across the pool and written in order
+    const arg_type block_rows = std::max<arg_type>(1, static_cast<arg_type>(detail::TEXT_FLUSH) / (cols * 8));
+    const arg_type blocks = (rows + block_rows - 1) / block_rows;
+    const arg_type batch = Parallel::num_threads() * 4;
+    std::vector<std::string> texts(batch);
+
+    for (arg_type first = 0; first < blocks; first += batch) {
+        const arg_type last = std::min(blocks, first + batch);
+        Parallel::parallel_for(first, last, [&](arg_type b, arg_type e) {
+            for (arg_type k = b; k < e; ++k) {
+                std::string& text = texts[k - first];
+                text.clear();
+                const arg_type row_end = std::min(rows, (k + 1) * block_rows);
+                for (arg_type r = k * block_rows; r < row_end; ++r) {
+                    const T* row = arr.data() + r * cols;
+                    for (arg_type c = 0; c < cols; ++c) {
+                        if (c) text += delimiter;
+                        detail::append_value(text, row[c], precision);
+                    }
+                    text += '\n';
+                }
+            }
+        }, 1);
+        for (arg_type k = first; k < last; ++k) file.write(texts[k - first].data(), texts[k - first].size());
+    }
+    if (!file) throw std::runtime_error("savetxt::Failed writing " + path);
+}
+
+}
+
+namespace SamH::NumC::Global
+{
+
+// ----------------- PRINTING -----------------
+
+namespace detail
+{
+    // Array::print_data: rows of the last axis, one per line, collected in a buffer and
+    // written in large pieces. Past the print threshold only the edge rows and columns
+    // are shown.
+    template <typename Values>
+    void print_values(const Values& values, const Shape& dims)
+    {
+        if (values.empty() || dims.empty()) {
+            return;
+        }
+        const arg_type cols = dims.back();
+        if (cols == 0) {
+            return;
+        }
+        const arg_type rows = static_cast<arg_type>(values.size()) / cols;
+        const arg_type tail = static_cast<arg_type>(values.size()) % cols;
+
+        const PrintOptions options = print_options();
+        const bool summarize = static_cast<arg_type>(values.size()) > options.threshold;
+        const arg_type edge = options.edge_items;
+        const bool skip_rows = summarize && rows > 2 * edge;
+        const bool skip_cols = summarize && cols > 2 * edge;
+
+        std::string buffer;
+        auto print_row = [&](arg_type first, arg_type count) {
+            for (arg_type c = 0; c < count; ++c) {
+                if (skip_cols && count == cols && c == edge) {
+                    buffer += "... ";
+                    c = cols - edge;
+                }
+                append_value(buffer, values[first + c], options.precision);
+                buffer += ' ';
+            }
+            buffer += '\n';
+            flush_text(buffer, std::cout);
+        };
+
+        for (arg_type r = 0; r < rows; ++r) {
+            if (skip_rows && r == edge) {
+                buffer += "...\n";
+                r = rows - edge;
+            }
+            print_row(r * cols, cols);
+        }
+        if (tail) print_row(rows * cols, tail);
+        flush_text(buffer, std::cout, true);
+        std::cout.flush();
+    }
+}
+
+}
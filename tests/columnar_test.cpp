@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "Array.hpp"
+#include "columnar.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <unistd.h>
+
+using namespace SamH::NumC;
+
+namespace
+{
+    std::string temp_path(const std::string& name)
+    {
+        return "/tmp/numc_" + name + "_" + std::to_string(::getpid()) + ".col";
+    }
+
+    template <typename T>
+    void expect_round_trip(const Array<T>& arr, const std::string& name, arg_type chunk_size)
+    {
+        const std::string path = temp_path(name);
+        Columnar::write(path, arr, chunk_size);
+        Columnar::Reader<T> reader(path);
+        const Array<T> back = reader.read();
+        std::remove(path.c_str());
+
+        ASSERT_EQ(back.size(), arr.size());
+        for (arg_type i = 0; i < arr.size(); ++i) EXPECT_EQ(back.data()[i], arr.data()[i]) << "at " << i;
+    }
+}
+
+// Arithmetic progressions pick DELTA with zero-width differences
+TEST(Columnar, RoundTripsArange)
+{
+    Array<long> arr = Array<long>::uninitialized(Shape{4096});
+    std::iota(arr.begin(), arr.end(), 0L);
+    expect_round_trip(arr, "arange", 4096);
+}
+
+TEST(Columnar, RoundTripsConstantStep)
+{
+    Array<std::int64_t> arr = Array<std::int64_t>::uninitialized(Shape{10000});
+    for (arg_type i = 0; i < arr.size(); ++i) arr.data()[i] = 1600000000000LL + i * 1000;
+    expect_round_trip(arr, "step", 1000);
+
+    Array<int> single{42};
+    expect_round_trip(single, "single", 16);
+}
+
+// A chunk of -0.0 and 0.0 has min == max but isn't constant
+TEST(Columnar, KeepsSignedZeros)
+{
+    Array<double> arr{0.0, -0.0, 0.0, -0.0};
+    const std::string path = temp_path("zeros");
+    Columnar::write(path, arr, 4);
+    const Array<double> back = Columnar::Reader<double>(path).read();
+    std::remove(path.c_str());
+
+    ASSERT_EQ(back.size(), arr.size());
+    for (arg_type i = 0; i < arr.size(); ++i) EXPECT_EQ(std::signbit(back.data()[i]), std::signbit(arr.data()[i]));
+}